@@ -0,0 +1,299 @@
+/* bench.c - throughput benchmark for meta_parser.h
+
+   Generates a synthetic schema in memory and times the two phases of a
+   parse separately:
+
+        parse  lexing, parsing and resolving field types
+        emit   laying out the objects and writing the header into memory
+
+   Build from this directory with:
+        cc -O2 -std=c99 -I.. bench.c -o bench
+
+   Usage:
+        ./bench [--objects N] [--fields N] [--depth N] [--comments P]
+                [--errors P] [--options N] [--iterations N] [--seed N]
+                [--dump]
+
+   --comments and --errors take a probability in [0, 1]: that of a comment
+   line before a field, and that of a field with an unresolved type or an
+   invalid name. --depth chains objects by value, each holding the one
+   before it, up to N levels deep. --options sets META_OPT_* flags on the
+   context. --dump writes the schema to stdout instead of timing it.
+
+   Each phase is run --iterations times on a fresh context and the fastest
+   run is reported. Results go to stdout, one JSON object per phase and line,
+   so CI can append them to a log; a readable summary goes to stderr.
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+/*
+ * Every allocation the parser makes goes through these, so a phase can report
+ * how many it made. The header is included after the macros, in this file
+ * only, and picks them up in place of the C library functions.
+ */
+static size_t bench_allocs;
+static size_t bench_alloc_bytes;
+
+static void *bench_malloc(size_t size) {
+    bench_allocs++;
+    bench_alloc_bytes += size;
+    return malloc(size);
+}
+
+static void *bench_calloc(size_t count, size_t size) {
+    bench_allocs++;
+    bench_alloc_bytes += count * size;
+    return calloc(count, size);
+}
+
+static void *bench_realloc(void *ptr, size_t size) {
+    bench_allocs++;
+    bench_alloc_bytes += size;
+    return realloc(ptr, size);
+}
+
+#define malloc bench_malloc
+#define calloc bench_calloc
+#define realloc bench_realloc
+#define META_PARSER_IMPLEMENTATION
+#include "meta_parser.h"
+#undef malloc
+#undef calloc
+#undef realloc
+
+typedef struct bench_config {
+    long objects;
+    long fields;
+    long depth;
+    double comments;
+    double errors;
+    unsigned int options;
+    long iterations;
+    unsigned long seed;
+    int dump;
+} bench_config;
+
+typedef struct bench_result {
+    double seconds;      // Fastest run
+    size_t allocs;       // Allocations of one run
+    size_t alloc_bytes;
+    size_t output_bytes;
+} bench_result;
+
+static double bench_now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double)count.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Peak resident set size of the process in bytes, 0 if unknown
+static size_t bench_peak_rss(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return (size_t)counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;  // Bytes on macOS
+#else
+    return (size_t)usage.ru_maxrss * 1024;  // Kilobytes elsewhere
+#endif
+#endif
+}
+
+// 64-bit LCG, so a seed gives the same schema everywhere
+static unsigned long long bench_state;
+
+static double bench_random(void) {
+    bench_state = bench_state * 6364136223846793005ull + 1442695040888963407ull;
+    return (double)(bench_state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static const char *bench_types[] = {
+    "int", "float", "double", "char", "u8", "u16", "u32", "u64",
+    "i32", "unsigned int", "long long", "_Bool", "float[4]", "u8[16]",
+};
+
+/**
+ * Writes a synthetic schema into `out`.
+ *
+ * @param out    Buffer the schema is appended to.
+ * @param config Size and shape of the schema.
+ * @param lines  Receives the number of lines written.
+ */
+static void bench_schema(meta_buffer *out, const bench_config *config, size_t *lines) {
+    size_t type_count = sizeof(bench_types) / sizeof(bench_types[0]);
+    bench_state = config->seed;
+    *lines = 0;
+
+    for (long i = 0; i < config->objects; i++) {
+        meta_buffer_printf(out, "obj :: Obj%ld {\n", i);
+        ++*lines;
+        // Each object holds the previous one, restarting the chain every `depth` objects
+        long link = config->depth > 0 ? i % (config->depth + 1) : 0;
+        for (long f = 0; f < config->fields; f++) {
+            if (bench_random() < config->comments) {
+                meta_buffer_printf(out, "    # Field %ld of object %ld\n", f, i);
+                ++*lines;
+            }
+            if (bench_random() < config->errors) {
+                if (bench_random() < 0.5) meta_buffer_printf(out, "    field%ld :: Missing%ld\n", f, i);
+                else meta_buffer_printf(out, "    %ldfield :: int\n", f);
+            } else if (f == 0 && link > 0) {
+                meta_buffer_printf(out, "    field%ld :: Obj%ld\n", f, i - 1);
+            } else {
+                meta_buffer_printf(out, "    field%ld :: %s\n", f, bench_types[(size_t)(bench_random() * (double)type_count)]);
+            }
+            ++*lines;
+        }
+        meta_buffer_printf(out, "}\n\n");
+        *lines += 2;
+    }
+}
+
+/**
+ * Parses `src` `config->iterations` times, each time in a fresh context, and
+ * measures the parse and emit phases.
+ *
+ * @return 0 on success, -1 if a run ran out of memory.
+ */
+static int bench_run(const bench_config *config, const meta_buffer *src, bench_result *parse, bench_result *emit) {
+    memset(parse, 0, sizeof(*parse));
+    memset(emit, 0, sizeof(*emit));
+
+    for (long run = 0; run < config->iterations; run++) {
+        meta_context ctx;
+        meta_buffer out = {0};
+        meta_context_init(&ctx);
+        ctx.options = config->options;
+
+        bench_allocs = bench_alloc_bytes = 0;
+        double start = bench_now();
+        meta_object *first = meta_parse_source(&ctx, src->data, src->length);
+        meta_resolve_objects(&ctx, first);
+        double parsed = bench_now();
+        size_t parse_allocs = bench_allocs, parse_bytes = bench_alloc_bytes;
+
+        bench_allocs = bench_alloc_bytes = 0;
+        int failed = meta_apply_options(first, ctx.options) != 0;
+        meta_check_objects(&ctx, first);
+        failed = failed || meta_write_objects(&out, NULL, first) != 0 || out.failed;
+        double emitted = bench_now();
+
+        if (run == 0 || parsed - start < parse->seconds) parse->seconds = parsed - start;
+        if (run == 0 || emitted - parsed < emit->seconds) emit->seconds = emitted - parsed;
+        parse->allocs = parse_allocs;
+        parse->alloc_bytes = parse_bytes;
+        emit->allocs = bench_allocs;
+        emit->alloc_bytes = bench_alloc_bytes;
+        emit->output_bytes = out.length;
+
+        meta_buffer_free(&out);
+        meta_context_free(&ctx);
+        if (failed) return -1;
+    }
+    return 0;
+}
+
+// `bytes` is what the phase got through: the input when parsing, the header when emitting
+static void bench_report(const char *phase, const bench_config *config, const bench_result *result, size_t lines, size_t input, size_t bytes) {
+    double seconds = result->seconds > 0 ? result->seconds : 1e-9;
+    double objects = config->objects > 0 ? (double)config->objects : 1.0;
+    printf(
+        "{\"phase\":\"%s\",\"objects\":%ld,\"fields\":%ld,\"depth\":%ld,\"comments\":%g,\"errors\":%g,"
+        "\"options\":%u,\"iterations\":%ld,\"seed\":%lu,\"input_lines\":%lu,\"input_bytes\":%lu,"
+        "\"output_bytes\":%lu,\"seconds\":%.9f,\"lines_per_s\":%.0f,\"mb_per_s\":%.3f,"
+        "\"allocs_per_object\":%.3f,\"alloc_bytes_per_object\":%.1f,\"peak_rss\":%lu}\n",
+        phase, config->objects, config->fields, config->depth, config->comments, config->errors,
+        config->options, config->iterations, config->seed, (unsigned long)lines, (unsigned long)input,
+        (unsigned long)result->output_bytes, result->seconds, (double)lines / seconds,
+        (double)bytes / seconds / 1e6, (double)result->allocs / objects, (double)result->alloc_bytes / objects,
+        (unsigned long)bench_peak_rss()
+    );
+    fprintf(
+        stderr,
+        "%-5s  %10.3f ms  %12.0f lines/s  %9.2f MB/s  %8.2f allocs/object\n",
+        phase, result->seconds * 1e3, (double)lines / seconds, (double)bytes / seconds / 1e6, (double)result->allocs / objects
+    );
+}
+
+static int bench_usage(const char *program) {
+    fprintf(
+        stderr,
+        "usage: %s [--objects N] [--fields N] [--depth N] [--comments P] [--errors P]\n"
+        "          [--options N] [--iterations N] [--seed N] [--dump]\n",
+        program
+    );
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    bench_config config = { 10000, 8, 0, 0.0, 0.0, 0, 10, 1, 0 };
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--dump") == 0) { config.dump = 1; continue; }
+        if (!value) return bench_usage(argv[0]);
+        if (strcmp(arg, "--objects") == 0) config.objects = strtol(value, NULL, 10);
+        else if (strcmp(arg, "--fields") == 0) config.fields = strtol(value, NULL, 10);
+        else if (strcmp(arg, "--depth") == 0) config.depth = strtol(value, NULL, 10);
+        else if (strcmp(arg, "--comments") == 0) config.comments = strtod(value, NULL);
+        else if (strcmp(arg, "--errors") == 0) config.errors = strtod(value, NULL);
+        else if (strcmp(arg, "--options") == 0) config.options = (unsigned int)strtoul(value, NULL, 0);
+        else if (strcmp(arg, "--iterations") == 0) config.iterations = strtol(value, NULL, 10);
+        else if (strcmp(arg, "--seed") == 0) config.seed = strtoul(value, NULL, 10);
+        else return bench_usage(argv[0]);
+        i++;
+    }
+    if (config.objects < 0 || config.fields < 0 || config.depth < 0 || config.iterations < 1) return bench_usage(argv[0]);
+    // The cache would read and write files next to an input that does not exist
+    config.options &= ~META_OPT_CACHE;
+
+    size_t lines;
+    meta_buffer src = {0};
+    bench_schema(&src, &config, &lines);
+    if (src.failed) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    if (config.dump) {
+        fwrite(src.data, 1, src.length, stdout);
+        meta_buffer_free(&src);
+        return 0;
+    }
+
+    bench_result parse, emit;
+    if (bench_run(&config, &src, &parse, &emit) != 0) {
+        fprintf(stderr, "out of memory\n");
+        meta_buffer_free(&src);
+        return 1;
+    }
+    bench_report("parse", &config, &parse, lines, src.length, src.length);
+    bench_report("emit", &config, &emit, lines, src.length, emit.output_bytes);
+
+    meta_buffer_free(&src);
+    return 0;
+}
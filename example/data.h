@@ -6,16 +6,16 @@ typedef struct PlayerData {
    float position;
 } PlayerData;
 
-typedef struct WorldData {
-   PlayerData player;
-   // Enemy enemy;  // Error: Unresolved or invalid type 'Enemy'
-} WorldData;
-
 typedef struct EnemyData {
    // int !health;  // Error: Cannot use special characters or numbers in field names.
    float position;
 } EnemyData;
 
+typedef struct WorldData {
+   PlayerData player;
+   EnemyData enemy;
+} WorldData;
+
 // Duplicate object name 'Enemy'
 // typedef struct EnemyData {
 // } EnemyData;
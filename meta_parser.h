@@ -1,4 +1,4 @@
-/* meta_parser.h - v1.2.2
+/* meta_parser.h - v2.24.0
    An STB-Style single-file C header library for generating C structs from metadata files.
    This was done for fun!
 
@@ -32,6 +32,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #define CHAR_SET_SIZE 256
 
@@ -78,439 +81,5507 @@ static int _meta_ends_with(const char *str, const char *chars) {
     return 0;
 }
 
-static const char* valid_c_types[] = {
-    "char",
-    "signed char",
-    "unsigned char",
-    "short",
-    "short int",
-    "signed short",
-    "signed short int",
-    "unsigned short",
-    "unsigned short int",
-    "int",
-    "signed int",
-    "unsigned int",
-    "long",
-    "long int",
-    "signed long",
-    "signed long int",
-    "unsigned long",
-    "unsigned long int",
-    "long long",
-    "long long int",
-    "signed long long",
-    "signed long long int",
-    "unsigned long long",
-    "unsigned long long int",
-    "float",
-    "double",
-    "long double",
-    "_Bool",
-    "size_t",
-
-    NULL  // Null terminator
-};
+// Simple hash function (djb2) over a byte slice, see: https://theartincode.stanis.me/008-djb2/
+static unsigned int meta_hash_bytes(const char *str, size_t len) {
+    unsigned int hash = 5381;
+    for (size_t i = 0; i < len; i++) {
+        hash = ((hash << 5) + hash) + (unsigned char)str[i];  // hash * 33 + c
+    }
+    return hash;
+}
+
+#define META_C_TYPE     1   // Built-in C type
+#define META_C_KEYWORD  2   // Reserved C keyword
+#define META_C_STDINT   4   // Needs <stdint.h>
+#define META_C_ALIAS    8   // Short name for another type, see `meta_c_alias`
+#define META_C_INTEGER  16  // Integer type, usable for bitfields
+#define META_C_UNSIGNED 32  // Unsigned integer type
+
+#if defined(__cplusplus)
+    #define META_ALIGNOF(T) alignof(T)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+    #define META_ALIGNOF(T) _Alignof(T)
+#else
+    #define META_ALIGNOF(T) offsetof(struct { char c; T t; }, t)
+#endif
+
+// Size and alignment of a C type on the platform the generator is built for
+#define META_C_LAYOUT(T) sizeof(T), META_ALIGNOF(T)
+
+#ifdef __cplusplus
+    #define META_C_BOOL bool  // Same layout as _Bool, which C++ does not know
+#else
+    #define META_C_BOOL _Bool
+#endif
+
+typedef struct meta_c_name {
+    const char *name;
+    unsigned char len;
+    unsigned char flags;
+    unsigned char size;   // 0 for keywords
+    unsigned char align;
+} meta_c_name;
+
+/*
+ * Perfect hash over every built-in C type and keyword. The table is fully
+ * static, so lookups need no initialization and are safe from any thread.
+ *
+ * The hash is FNV-1a with META_C_NAMES_SEED as offset basis, keeping the top
+ * META_C_NAMES_BITS bits. The seed is the first one for which no two names
+ * share a slot; when adding a name, search for a new seed and rebuild
+ * meta_c_name_slots.
+ */
+#define META_C_NAMES_SEED 0x157EBu
+#define META_C_NAMES_BITS 8
 
-static const char* c_keywords[] = {
-    "auto",
-    "break",
-    "case",
-    "char",
-    "const",
-    "continue",
-    "default",
-    "do",
-    "else",
-    "enum",
-    "extern",
-    "for",
-    "goto",
-    "if",
-    "register",
-    "return",
-    "sizeof",
-    "static",
-    "struct",
-    "switch",
-    "typedef",
-    "union",
-    "unsigned",
-    "void",
-    "volatile",
-    "while",
-
-    NULL
+static const meta_c_name meta_c_names[] = {
+    { "char",                    4, META_C_TYPE | META_C_KEYWORD | META_C_INTEGER, META_C_LAYOUT(char) },
+    { "signed char",            11, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(signed char) },
+    { "unsigned char",          13, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(unsigned char) },
+    { "short",                   5, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(short) },
+    { "short int",               9, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(short int) },
+    { "signed short",           12, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(signed short) },
+    { "signed short int",       16, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(signed short int) },
+    { "unsigned short",         14, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(unsigned short) },
+    { "unsigned short int",     18, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(unsigned short int) },
+    { "int",                     3, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(int) },
+    { "signed int",             10, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(signed int) },
+    { "unsigned int",           12, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(unsigned int) },
+    { "long",                    4, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(long) },
+    { "long int",                8, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(long int) },
+    { "signed long",            11, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(signed long) },
+    { "signed long int",        15, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(signed long int) },
+    { "unsigned long",          13, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(unsigned long) },
+    { "unsigned long int",      17, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(unsigned long int) },
+    { "long long",               9, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(long long) },
+    { "long long int",          13, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(long long int) },
+    { "signed long long",       16, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(signed long long) },
+    { "signed long long int",   20, META_C_TYPE | META_C_INTEGER, META_C_LAYOUT(signed long long int) },
+    { "unsigned long long",     18, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(unsigned long long) },
+    { "unsigned long long int", 22, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(unsigned long long int) },
+    { "float",                   5, META_C_TYPE, META_C_LAYOUT(float) },
+    { "double",                  6, META_C_TYPE, META_C_LAYOUT(double) },
+    { "long double",            11, META_C_TYPE, META_C_LAYOUT(long double) },
+    { "_Bool",                   5, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(META_C_BOOL) },
+    { "size_t",                  6, META_C_TYPE | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(size_t) },
+    { "int8_t",                  6, META_C_TYPE | META_C_STDINT | META_C_INTEGER, META_C_LAYOUT(int8_t) },
+    { "int16_t",                 7, META_C_TYPE | META_C_STDINT | META_C_INTEGER, META_C_LAYOUT(int16_t) },
+    { "int32_t",                 7, META_C_TYPE | META_C_STDINT | META_C_INTEGER, META_C_LAYOUT(int32_t) },
+    { "int64_t",                 7, META_C_TYPE | META_C_STDINT | META_C_INTEGER, META_C_LAYOUT(int64_t) },
+    { "uint8_t",                 7, META_C_TYPE | META_C_STDINT | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(uint8_t) },
+    { "uint16_t",                8, META_C_TYPE | META_C_STDINT | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(uint16_t) },
+    { "uint32_t",                8, META_C_TYPE | META_C_STDINT | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(uint32_t) },
+    { "uint64_t",                8, META_C_TYPE | META_C_STDINT | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(uint64_t) },
+    { "i8",                      2, META_C_TYPE | META_C_STDINT | META_C_ALIAS | META_C_INTEGER, META_C_LAYOUT(int8_t) },
+    { "i16",                     3, META_C_TYPE | META_C_STDINT | META_C_ALIAS | META_C_INTEGER, META_C_LAYOUT(int16_t) },
+    { "i32",                     3, META_C_TYPE | META_C_STDINT | META_C_ALIAS | META_C_INTEGER, META_C_LAYOUT(int32_t) },
+    { "i64",                     3, META_C_TYPE | META_C_STDINT | META_C_ALIAS | META_C_INTEGER, META_C_LAYOUT(int64_t) },
+    { "u8",                      2, META_C_TYPE | META_C_STDINT | META_C_ALIAS | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(uint8_t) },
+    { "u16",                     3, META_C_TYPE | META_C_STDINT | META_C_ALIAS | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(uint16_t) },
+    { "u32",                     3, META_C_TYPE | META_C_STDINT | META_C_ALIAS | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(uint32_t) },
+    { "u64",                     3, META_C_TYPE | META_C_STDINT | META_C_ALIAS | META_C_INTEGER | META_C_UNSIGNED, META_C_LAYOUT(uint64_t) },
+    { "f32",                     3, META_C_TYPE | META_C_ALIAS, META_C_LAYOUT(float) },
+    { "f64",                     3, META_C_TYPE | META_C_ALIAS, META_C_LAYOUT(double) },
+    { "auto",                    4, META_C_KEYWORD, 0, 0 },
+    { "break",                   5, META_C_KEYWORD, 0, 0 },
+    { "case",                    4, META_C_KEYWORD, 0, 0 },
+    { "const",                   5, META_C_KEYWORD, 0, 0 },
+    { "continue",                8, META_C_KEYWORD, 0, 0 },
+    { "default",                 7, META_C_KEYWORD, 0, 0 },
+    { "do",                      2, META_C_KEYWORD, 0, 0 },
+    { "else",                    4, META_C_KEYWORD, 0, 0 },
+    { "enum",                    4, META_C_KEYWORD, 0, 0 },
+    { "extern",                  6, META_C_KEYWORD, 0, 0 },
+    { "for",                     3, META_C_KEYWORD, 0, 0 },
+    { "goto",                    4, META_C_KEYWORD, 0, 0 },
+    { "if",                      2, META_C_KEYWORD, 0, 0 },
+    { "register",                8, META_C_KEYWORD, 0, 0 },
+    { "return",                  6, META_C_KEYWORD, 0, 0 },
+    { "sizeof",                  6, META_C_KEYWORD, 0, 0 },
+    { "static",                  6, META_C_KEYWORD, 0, 0 },
+    { "struct",                  6, META_C_KEYWORD, 0, 0 },
+    { "switch",                  6, META_C_KEYWORD, 0, 0 },
+    { "typedef",                 7, META_C_KEYWORD, 0, 0 },
+    { "union",                   5, META_C_KEYWORD, 0, 0 },
+    { "unsigned",                8, META_C_KEYWORD, 0, 0 },
+    { "void",                    4, META_C_KEYWORD, 0, 0 },
+    { "volatile",                8, META_C_KEYWORD, 0, 0 },
+    { "while",                   5, META_C_KEYWORD, 0, 0 },
 };
 
-#define HASH_SIZE 64  // Ensure the load factor is ~0.5. (LF = (# items in array) / HASH_SIZE)
+// 1-based index into meta_c_names for every hash slot, 0 for an empty slot
+static const unsigned char meta_c_name_slots[1 << META_C_NAMES_BITS] = {
+     8,  0, 11, 27, 45,  0,  0, 50, 43, 18,  0,  0,  0,  0, 72,  2,
+     0,  0,  0,  1, 67,  0,  0,  0, 51,  0,  0,  0,  0,  0,  0, 19,
+     0,  0,  0,  0,  0, 14,  0,  0, 64,  0, 35, 16,  0, 24,  0,  0,
+     0,  0,  0, 29, 22,  0,  0,  0,  0, 55,  0, 53,  0, 25,  0, 57,
+     0, 63,  0, 31,  0,  0,  0,  0, 71,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0, 33,  0,  0,  0, 66,  0, 46, 12,
+     0,  0,  0,  0,  0,  0, 56,  0,  0,  0,  0,  0,  0,  0, 30,  0,
+     0, 17,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 69,  0,
+     0,  0,  9,  0,  0,  0,  0, 23,  0,  0,  0,  5,  0,  0,  0, 42,
+     0,  0,  0,  0, 44,  0, 58, 38,  7,  0,  0, 41,  3,  0, 15, 39,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 65,
+     0,  0,  0, 40,  0,  0,  0, 28, 68, 60, 49, 48,  0,  0,  0,  0,
+    34, 32,  0,  0,  0,  0,  0,  0,  0,  0,  0, 59, 61,  0, 47,  0,
+    37, 20, 26,  0,  0, 62,  0,  0,  0,  0,  0,  0,  0,  0,  0,  4,
+     0,  0, 54,  0,  0,  0,  6, 36, 70,  0,  0, 10, 21,  0,  0,  0,
+     0,  0,  0, 13,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 52,
+};
 
-// Simple hash function (djb2), see: https://theartincode.stanis.me/008-djb2/
-unsigned int _hash(const char *str) {
-    unsigned long hash = 5381;
-    while (*str) {
-        hash = ((hash << 5) + hash) + *str;  // hash * 33 + c
-        str++;
+static unsigned int meta_c_name_hash(const char *str, size_t len) {
+    unsigned int hash = META_C_NAMES_SEED;
+    for (size_t i = 0; i < len; i++) {
+        hash = ((hash ^ (unsigned char)str[i]) * 16777619u) & 0xffffffffu;
     }
-    return hash % HASH_SIZE;
+    return hash >> (32 - META_C_NAMES_BITS);
 }
 
-static int _meta_is_valid_c_type(const char* input) {
-    static const char *validCTypes[HASH_SIZE][4] = {{NULL}};  // Chained buckets with up to 4 items per bucket
-
-    // Initialize the hash map only once
-    static int initialized = 0;
-    if (!initialized) {
-        for (int i = 0; valid_c_types[i] != NULL; i++) {
-            unsigned int h = _hash(valid_c_types[i]);
-
-            // Add to the hash bucket (linear chaining within the array)
-            for (int j = 0; j < 4; j++) {
-                if (validCTypes[h][j] == NULL) {
-                    validCTypes[h][j] = valid_c_types[i];
-                    break;
-                }
-            }
-        }
-        initialized = 1;
-    }
+/**
+ * Looks a name up among the built-in C types and keywords with a single hash.
+ *
+ * @param str Start of the name (need not be NUL-terminated).
+ * @param len Length of the name in bytes.
+ * @return The table entry, or NULL for any other name.
+ */
+static const meta_c_name *meta_c_name_find(const char *str, size_t len) {
+    unsigned char slot = meta_c_name_slots[meta_c_name_hash(str, len)];
+    if (!slot) return NULL;
 
-    // Perform the lookup
-    unsigned int h = _hash(input);
-    for (int j = 0; j < 4 && validCTypes[h][j] != NULL; j++) {
-        if (strcmp(input, validCTypes[h][j]) == 0) {
-            // if (_meta_ends_with(input, "str")) return 1;
-            return 1;
-        }
+    const meta_c_name *entry = &meta_c_names[slot - 1];
+    if (entry->len == len && memcmp(entry->name, str, len) == 0) {
+        return entry;
     }
-    return 0;
+    return NULL;
 }
 
-static int _meta_is_c_keyword(const char* input) {
-    static const char *cKeywords[HASH_SIZE][4] = {{NULL}};  // Chained buckets with up to 4 items per bucket
-
-    // Initialize the hash map only once
-    static int initialized = 0;
-    if (!initialized) {
-        for (int i = 0; c_keywords[i] != NULL; i++) {
-            unsigned int h = _hash(c_keywords[i]);
+/**
+ * Classifies a name against the built-in C types and keywords.
+ *
+ * @return A combination of META_C_TYPE and META_C_KEYWORD, 0 for any other name.
+ */
+static int meta_c_name_flags(const char *str, size_t len) {
+    const meta_c_name *entry = meta_c_name_find(str, len);
+    return entry ? entry->flags : 0;
+}
 
-            // Add to the hash bucket (linear chaining within the array)
-            for (int j = 0; j < 4; j++) {
-                if (cKeywords[h][j] == NULL) {
-                    cKeywords[h][j] = c_keywords[i];
-                    break;
-                }
-            }
-        }
-        initialized = 1;
+/**
+ * Returns the C type a META_C_ALIAS name stands for, e.g. "uint8_t" for "u8",
+ * or NULL for any other name.
+ */
+static const char *meta_c_alias(const char *str, size_t len) {
+    static const char *const aliases[][2] = {
+        { "i8",  "int8_t" },  { "i16", "int16_t" },  { "i32", "int32_t" },  { "i64", "int64_t" },
+        { "u8",  "uint8_t" }, { "u16", "uint16_t" }, { "u32", "uint32_t" }, { "u64", "uint64_t" },
+        { "f32", "float" },   { "f64", "double" },
+    };
+    if (!(meta_c_name_flags(str, len) & META_C_ALIAS)) return NULL;
+    for (size_t i = 0; i < sizeof(aliases) / sizeof(aliases[0]); i++) {
+        if (strlen(aliases[i][0]) == len && memcmp(aliases[i][0], str, len) == 0) return aliases[i][1];
     }
+    return NULL;
+}
 
-    // Perform the lookup
-    unsigned int h = _hash(input);
-    for (int j = 0; j < 4 && cKeywords[h][j] != NULL; j++) {
-        if (strcmp(input, cKeywords[h][j]) == 0) {
-            return 1;
-        }
-    }
-    return 0;
+// Aliases are not C types, so they stay usable as field names
+static int _meta_is_valid_c_type(const char* input) {
+    return (meta_c_name_flags(input, strlen(input)) & (META_C_TYPE | META_C_ALIAS)) == META_C_TYPE;
 }
 
+/* Context options, combine in `meta_context.options`. */
+#define META_OPT_CACHE         0x1u  // Keep a binary `.metac` cache next to each input, see README
+#define META_OPT_SERIALIZE     0x2u  // Generate binary `XData_write`/`XData_read`, also set by `@serialize`
+#define META_OPT_REORDER       0x4u  // Order members by alignment to minimize padding, also set by `@reorder`
+#define META_OPT_ASSERT_LAYOUT 0x8u  // Emit static asserts on struct size and offsets, also set by `@assert_layout`
+#define META_OPT_SOA           0x10u // Generate an `XDataSoA` structure-of-arrays container, also set by `@soa`
+#define META_OPT_REFLECT       0x20u // Generate an `XData_fields` reflection table, also set by `@reflect`
+#define META_OPT_DELTA         0x40u // Generate dirty tracking and delta encoding, also set by `@delta`; implies META_OPT_SERIALIZE
+#define META_OPT_HASH          0x80u // Generate `XData_eq` and `XData_hash`, also set by `@hash`
+#define META_OPT_LITTLE_ENDIAN 0x100u // Serialize in little-endian byte order on every host, also set by `@little_endian`; implies META_OPT_SERIALIZE
+#define META_OPT_VIEW          0x200u // Generate `XDataView` accessors over serialized buffers, also set by `@view`; implies META_OPT_SERIALIZE
+#define META_OPT_TEXT          0x400u // Generate `XData_load_text` for text instance data, also set by `@text`
+#define META_OPT_CPP           0x800u // Generate a C++ `meta::schema<XData>` specialization, also set by `@cpp`
+
+#ifndef META_PARSER_SINK_CHUNK
+#define META_PARSER_SINK_CHUNK (64 * 1024)  // Buffered output bytes before a sink is called
+#endif
 
-#define MAX_LINE 256
-#define MAX_NAME 64
-#define MAX_FIELDS 50
+#ifndef META_PARSER_WATCH_POLL_MS
+#define META_PARSER_WATCH_POLL_MS 250  // Interval at which `meta_watch_wait` rereads the inputs where it cannot be notified
+#endif
 
-#ifndef META_PARSER_MAX_LINE
-#define META_PARSER_MAX_LINE 256
+#ifndef META_PARSER_WATCH_SETTLE_MS
+#define META_PARSER_WATCH_SETTLE_MS 20  // Quiet time after a change before rebuilding, so a save in several writes counts once
 #endif
 
-#ifndef META_PARSER_MAX_NAME
-#define META_PARSER_MAX_NAME 64
+#ifndef META_PARSER_CACHE_LINE
+#define META_PARSER_CACHE_LINE 64  // Bytes per cache line for `@cacheline` without a size
 #endif
 
-#ifndef META_PARSER_MAX_FIELDS
-#define META_PARSER_MAX_FIELDS 32
+#ifndef META_PARSER_ARENA_BLOCK
+#define META_PARSER_ARENA_BLOCK (64 * 1024)  // Bytes per arena block, larger requests get their own block
 #endif
 
 typedef struct meta_field {
-    char name[MAX_NAME];
-    char type[MAX_NAME];
+    const char *name;             // Interned, lives in the context arena
+    const char *type;             // Type as written in the metadata file, interned
+    struct meta_object *object;   // Object the type resolved to, emitted as `<type>Data`
+    int count;                    // Array length, 0 for a single value
+    int bits;                     // Bitfield width, 0 for a plain member, -1 if invalid
+    unsigned int align_request;   // Alignment asked for with `@align(N)`, 0 for none
     int name_valid;
     int type_valid;
+    int cyclic;                   // Dropped because the object would contain itself by value
+    int hot;                      // 1 with `@hot`, -1 with `@cold`, 0 otherwise
+    int line;                     // Position of the field name in the input, 1-based, 0 if unknown
+    int column;
 } meta_field;
 
 typedef struct meta_object {
-    char name[MAX_NAME];
-    meta_field fields[MAX_FIELDS];
+    const char *name;  // Interned, lives in the context arena
+    meta_field *fields;
     int field_count;
     int valid;
     int duplicate;
+    int index;                 // Declaration order within its context
+    unsigned int options;      // META_OPT_* code generation flags from attributes and the context
+    unsigned int align_request;  // Alignment asked for with `@align(N)`, 0 for none
+    unsigned int pool_capacity;  // Capacity asked for with `@pool(N)`, 0 for no pool
+    unsigned int version;      // Schema version set with `@version(N)`, 0 if unversioned
+    unsigned int cacheline;    // Cache line size asked for with `@cacheline`, 0 for none
+    struct meta_object *prior; // Earlier layouts kept by the cache, oldest first, see `meta_cache_history`
+    const struct meta_object *cold_of;  // Object whose `@cold` members this companion holds, NULL otherwise
+    size_t size;               // Host size and alignment of the struct, see `meta_layout_objects`
+    size_t align;
+    size_t hot_size;           // Bytes up to the end of the last `@hot` member, 0 without any
+    int layout;                // 0 not computed, 1 in progress, 2 done
+    int bitfields;             // Has bitfields, directly or in members, so `size` is only an estimate
+    const char *scalar;        // Type of every scalar in a META_OPT_LITTLE_ENDIAN object, NULL if they differ
+    uint64_t schema;           // Hash of the wire layout of a META_OPT_VIEW object
+    int file;                  // Index of the batch input that declared it, 0 outside batches
+    int line;                  // Position of the object name in the input, 1-based, 0 if unknown
+    int column;
+    struct meta_object *next;  // Next object in declaration order
 } meta_object;
 
-struct {
-    meta_object objects[MAX_FIELDS];
+/**
+ * Bump allocator. Everything a parse produces (objects, fields and names) is
+ * carved out of its blocks and released in one go with the context.
+ */
+typedef struct meta_arena_block {
+    struct meta_arena_block *next;
+    size_t used;
+    size_t capacity;
+} meta_arena_block;
+
+typedef struct meta_arena {
+    meta_arena_block *head;
+} meta_arena;
+
+typedef struct meta_intern_entry {
+    const char *str;
+    size_t len;
+    unsigned int hash;
+    meta_object *object;  // First object declared with this name, if any
+} meta_intern_entry;
+
+/**
+ * Open-addressing table of every distinct name seen by a context, so equal
+ * names share one arena copy. It doubles as the type registry: resolving a
+ * field type or spotting a duplicate object is a single probe.
+ */
+typedef struct meta_intern_table {
+    meta_intern_entry *slots;
+    size_t capacity;  // Always zero or a power of two
+    size_t count;
+} meta_intern_table;
+
+/**
+ * Growable byte buffer that generated code is rendered into.
+ */
+typedef struct meta_buffer {
+    char *data;
+    size_t length;
+    size_t capacity;
+    int failed;  // Set once an allocation fails, further writes are dropped
+} meta_buffer;
+
+/**
+ * Destination for generated code. `write` receives the output in order, in
+ * one or more chunks, and returns 0 on success or non-zero to abort.
+ */
+typedef struct meta_sink {
+    int (*write)(void *user, const char *data, size_t len);
+    void *user;
+} meta_sink;
+
+/**
+ * One input/output pair of a batch run. `result` is filled in by
+ * `meta_parse_batch` with 0 on success or -1 on failure.
+ */
+typedef struct meta_batch_file {
+    const char *input_file;
+    const char *output_file;
+    int result;
+} meta_batch_file;
+
+typedef enum meta_severity {
+    META_SEVERITY_WARNING,
+    META_SEVERITY_ERROR
+} meta_severity;
+
+typedef enum meta_diagnostic_code {
+    META_DIAG_OUT_OF_MEMORY = 1,
+    META_DIAG_UNKNOWN_ATTRIBUTE,    // Warning, the attribute is ignored
+    META_DIAG_DUPLICATE_OBJECT,
+    META_DIAG_INVALID_OBJECT_NAME,  // Object named like a C keyword or type
+    META_DIAG_INVALID_FIELD_NAME,
+    META_DIAG_UNRESOLVED_TYPE,
+    META_DIAG_INVALID_BITS,         // Bit width or range that does not fit the type
+    META_DIAG_CYCLIC_MEMBER,        // Member that would make an object contain itself
+    META_DIAG_IO,                   // Input that cannot be read or header that cannot be written
+    META_DIAG_HOT_SPILL,            // Warning, the `@hot` members do not fit in one cache line
+    META_DIAG_COLD_COLLISION        // Warning, the `@cold` companion name is taken, the members stay in place
+} meta_diagnostic_code;
+
+/**
+ * One warning or error found while parsing. Objects and fields with errors
+ * are commented out in the generated header.
+ */
+typedef struct meta_diagnostic {
+    meta_severity severity;
+    meta_diagnostic_code code;
+    const char *file;     // Input file, NULL when parsing from memory
+    int line;             // 1-based, 0 if unknown
+    int column;
+    const char *message;  // Lives in the context arena
+} meta_diagnostic;
+
+#ifdef META_PARSER_STATS
+/**
+ * What one parse spent its time on, compiled in with `META_PARSER_STATS`.
+ * Times are in seconds from a monotonic clock. Define the macro the same way
+ * in every file that includes this header, it changes `meta_context`.
+ */
+typedef struct meta_stats {
+    const char *input_file;   // NULL when parsing from memory or for batch totals
+    double io_seconds;        // Reading the input and writing the header
+    double parse_seconds;     // Lexing and parsing, or loading the cache instead
+    double resolve_seconds;   // Resolving field types against the objects
+    double emit_seconds;      // Laying out the objects and generating code
+    size_t bytes;             // Input bytes
+    size_t lines;
+    size_t objects;
+    size_t fields;
+    size_t object_lookups;    // Registry probes resolving a field type
+    size_t c_type_lookups;    // C name table lookups classifying names and types while parsing
+    size_t errors;            // Invalid objects and fields, as commented out in the header
+} meta_stats;
+
+/* Called with the statistics of each parse once it finished. */
+typedef void (*meta_stats_callback)(void *user, const meta_stats *stats);
+#endif
+
+/**
+ * All state of a single parse. Each thread can own its own context and parse
+ * independently of the others.
+ */
+typedef struct meta_context {
+    unsigned int options;       // META_OPT_* flags, kept by `meta_context_free`
+    meta_arena arena;
+    meta_intern_table names;
+    meta_object *objects;       // First object in declaration order
+    meta_object *objects_tail;
     size_t objects_length;
-} meta_parser_state;
+    meta_field *scratch;        // Fields of the object currently being parsed
+    int scratch_count;
+    int scratch_capacity;
+    meta_diagnostic *diagnostics;  // Of every parse since the context was cleared, in order
+    size_t diagnostic_count;
+    size_t diagnostic_capacity;
+    const char *input_file;     // Input being parsed, for diagnostics
+#ifdef META_PARSER_STATS
+    meta_stats stats;                    // Of the last parse, reset when the next one starts
+    meta_stats_callback stats_callback;  // Kept by `meta_context_free`, like `options`
+    void *stats_user;
+    double stats_mark;                   // Start of the phase being timed
+#endif
+} meta_context;
+
+/**
+ * Batch run kept alive between changes to its inputs, see `meta_watch_init`.
+ * Every input stays parsed in memory; only those that change are parsed again.
+ */
+typedef struct meta_watch {
+    meta_context report;              // Diagnostics and, with META_PARSER_STATS, statistics of the last build
+    struct meta_watch_state *state;   // Everything else, owned by the implementation
+} meta_watch;
+
+/* Default context used by `meta_parse_init` and `meta_parse`. */
+extern meta_context meta_parser_state;
 
 /* FUNCTION DECLARATIONS */
 
+void meta_context_init(meta_context *ctx);
+void meta_context_free(meta_context *ctx);
+int meta_parse_ctx(meta_context *ctx, const char *input_file, const char *output_file);
+
+int meta_parse_buffer_ctx(meta_context *ctx, const char *src, size_t len, meta_sink sink);
+
 void meta_parse_init();
 int meta_parse(const char *input_file, const char *output_file);
+int meta_parse_buffer(const char *src, size_t len, meta_sink sink);
+
+int meta_parse_batch(meta_context *ctx, meta_batch_file *files, size_t count, int threads);
+
+int meta_watch_init(meta_watch *watch, const meta_context *ctx, meta_batch_file *files, size_t count, int threads);
+int meta_watch_wait(meta_watch *watch, int timeout_ms);
+void meta_watch_free(meta_watch *watch);
+
+meta_sink meta_buffer_sink(meta_buffer *buf);
+void meta_buffer_free(meta_buffer *buf);
+
+void meta_diagnostics_print(const meta_context *ctx, FILE *out);
+void meta_diagnostics_clear(meta_context *ctx);
 
 #endif /* META_PARSER_H */
 
 /* --------------------------- IMPLEMENTATION ---------------------------- */
 #ifdef META_PARSER_IMPLEMENTATION
 
+#if !defined(META_PARSER_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+    #define META_PARSER_USE_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#if !defined(META_PARSER_NO_INOTIFY) && defined(__linux__)
+    #define META_PARSER_USE_INOTIFY
+    #include <errno.h>
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#elif defined(__unix__) || defined(__APPLE__)
+    #include <poll.h>  // Sleeping between polls of `meta_watch_wait`
+#endif
+
+#ifdef _WIN32
+    #include <windows.h>  // MoveFileExA, threads
+#elif defined(META_PARSER_THREADS)
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+meta_context meta_parser_state;
+
+/* -------------------------------- MEMORY ------------------------------- */
+
+#define META_ARENA_ALIGN (2 * sizeof(void *))
+#define META_ARENA_ROUND(n) (((n) + META_ARENA_ALIGN - 1) & ~(META_ARENA_ALIGN - 1))
+
 /**
- * Appends an object to the global parser state.
+ * Allocates `size` bytes from the arena. The memory is not cleared.
  *
- * @param obj The object to append.
+ * @param arena The arena to allocate from.
+ * @param size  Number of bytes requested.
+ * @return Pointer to the allocation, or NULL when out of memory.
  */
-static void meta_state_append(meta_object obj) {
-    if (meta_parser_state.objects_length < MAX_FIELDS) {
-        meta_parser_state.objects[meta_parser_state.objects_length++] = obj;
-    } else {
-        #ifdef META_LOG_CONSOLE
-            fprintf(stderr, "ERROR: Object list is full!\n");
-        #endif
+static void *meta_arena_alloc(meta_arena *arena, size_t size) {
+    const size_t header = META_ARENA_ROUND(sizeof(meta_arena_block));
+    meta_arena_block *block = arena->head;
+    size = META_ARENA_ROUND(size);
+
+    if (!block || block->capacity - block->used < size) {
+        size_t capacity = size > META_PARSER_ARENA_BLOCK ? size : META_PARSER_ARENA_BLOCK;
+        block = (meta_arena_block *)malloc(header + capacity);
+        if (!block) return NULL;
+        block->used = 0;
+        block->capacity = capacity;
+
+        // Oversized requests go behind the current block so its free space stays usable
+        if (arena->head && capacity > META_PARSER_ARENA_BLOCK) {
+            block->next = arena->head->next;
+            arena->head->next = block;
+        } else {
+            block->next = arena->head;
+            arena->head = block;
+        }
+    }
+
+    void *ptr = (char *)block + header + block->used;
+    block->used += size;
+    return ptr;
+}
+
+static void meta_arena_free(meta_arena *arena) {
+    meta_arena_block *block = arena->head;
+    while (block) {
+        meta_arena_block *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+}
+
+static int meta_intern_grow(meta_intern_table *table) {
+    size_t capacity = table->capacity ? table->capacity * 2 : 64;
+    meta_intern_entry *slots = (meta_intern_entry *)calloc(capacity, sizeof(*slots));
+    if (!slots) return 0;
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        meta_intern_entry *entry = &table->slots[i];
+        if (!entry->str) continue;
+        size_t j = entry->hash & (capacity - 1);
+        while (slots[j].str) j = (j + 1) & (capacity - 1);
+        slots[j] = *entry;
     }
+
+    free(table->slots);
+    table->slots = slots;
+    table->capacity = capacity;
+    return 1;
 }
 
 /**
- * Checks if a given type matches an existing object.
+ * Finds or creates the table entry for a name. The returned pointer is only
+ * valid until the next name is interned.
  *
- * @param type The field type to check.
- * @return 1 if the type matches an object name, 0 otherwise.
+ * @param ctx The parser context owning the table.
+ * @param str Start of the name (need not be NUL-terminated).
+ * @param len Length of the name in bytes.
+ * @return The entry holding the unique copy of the name, or NULL when out of memory.
  */
-static int meta_is_object_type(const char *type) {
-    for (size_t i = 0; i < meta_parser_state.objects_length; ++i) {
-        if (strcmp(type, meta_parser_state.objects[i].name) == 0) {
-            return 1;
+static meta_intern_entry *meta_intern_entry_for(meta_context *ctx, const char *str, size_t len) {
+    meta_intern_table *table = &ctx->names;
+    if (table->count * 2 >= table->capacity && !meta_intern_grow(table)) return NULL;
+
+    unsigned int hash = meta_hash_bytes(str, len);
+    size_t i = hash & (table->capacity - 1);
+    while (table->slots[i].str) {
+        meta_intern_entry *entry = &table->slots[i];
+        if (entry->hash == hash && entry->len == len && memcmp(entry->str, str, len) == 0) {
+            return entry;
         }
+        i = (i + 1) & (table->capacity - 1);
     }
-    return 0;
+
+    char *copy = (char *)meta_arena_alloc(&ctx->arena, len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    table->slots[i].str = copy;
+    table->slots[i].len = len;
+    table->slots[i].hash = hash;
+    table->slots[i].object = NULL;
+    table->count++;
+    return &table->slots[i];
 }
 
 /**
- * Initializes the global parser state.
+ * Returns the context's unique, NUL-terminated copy of a name.
+ *
+ * @param ctx The parser context owning the copy.
+ * @param str Start of the name (need not be NUL-terminated).
+ * @param len Length of the name in bytes.
+ * @return The interned string, or NULL when out of memory.
  */
-void meta_parse_init() {
-    meta_parser_state.objects_length = 0;
+static const char *meta_intern(meta_context *ctx, const char *str, size_t len) {
+    meta_intern_entry *entry = meta_intern_entry_for(ctx, str, len);
+    return entry ? entry->str : NULL;
 }
 
+/* -------------------------------- STATE -------------------------------- */
+
 /**
- * Trims leading whitespace (spaces or tabs) from a line of text.
+ * Appends an object to the parser context.
  *
- * @param line Pointer to the line to trim. It will be updated to skip over whitespace.
- * @return 1 if the line becomes empty after trimming, 0 otherwise.
+ * @param ctx The parser context.
+ * @param obj The object to append. It is linked in place, not copied.
  */
-static int meta_trim_line(char *line) {
-    while (*line == ' ' || *line == '\t') line++;
-    return *line == 0; /* Return true if line is empty */
+static void meta_state_append(meta_context *ctx, meta_object *obj) {
+    obj->next = NULL;
+    if (ctx->objects_tail) ctx->objects_tail->next = obj;
+    else ctx->objects = obj;
+    ctx->objects_tail = obj;
+    ctx->objects_length++;
 }
 
+
 /**
- * Parses the start of an object definition from a line.
+ * Initializes a parser context. Must be called before the first parse with it.
  *
- * Expected format: "obj :: ObjectName {"
+ * @param ctx The parser context to reset.
+ */
+void meta_context_init(meta_context *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+/**
+ * Releases all memory owned by a parser context and leaves it ready for reuse.
+ * Objects, fields and names obtained from it become invalid.
  *
- * @param obj  Pointer to the `meta_object` to store the parsed object name.
- * @param line Input line containing the object definition.
- * @return 1 if parsing is successful, 0 otherwise.
+ * @param ctx The parser context to free.
  */
-static int meta_parse_object_start(meta_object *obj, const char *line) {
-    if (sscanf(line, "obj :: %63s {", obj->name) == 1) {
-        obj->valid = 0;
-        obj->duplicate = 0;
+void meta_context_free(meta_context *ctx) {
+    unsigned int options = ctx->options;
+#ifdef META_PARSER_STATS
+    meta_stats_callback stats_callback = ctx->stats_callback;
+    void *stats_user = ctx->stats_user;
+#endif
+    meta_arena_free(&ctx->arena);
+    free(ctx->names.slots);
+    free(ctx->scratch);
+    free(ctx->diagnostics);
+    meta_context_init(ctx);
+    ctx->options = options;
+#ifdef META_PARSER_STATS
+    ctx->stats_callback = stats_callback;
+    ctx->stats_user = stats_user;
+#endif
+}
 
-        if (!_meta_is_valid_c_type(obj->name) && !_meta_is_c_keyword(obj->name)) {
-            obj->valid = 1;
-        }
+/**
+ * Initializes the default parser context, releasing anything from earlier parses.
+ */
+void meta_parse_init() {
+    meta_context_free(&meta_parser_state);
+}
 
-        if (meta_is_object_type(obj->name)) {
-            obj->duplicate = 1;
-            obj->valid = 0;
-        }
+/* -------------------------------- STATS -------------------------------- */
 
-        obj->field_count = 0;
+#ifdef META_PARSER_STATS
+    #include <time.h>
 
-        if (!obj->duplicate) {
-            meta_state_append(*obj);
-        }
+    #define META_STAT_BEGIN(ctx) meta_stats_begin(ctx)
+    #define META_STAT_START(ctx) ((ctx)->stats_mark = meta_stats_now())
+    #define META_STAT_PHASE(ctx, phase) meta_stats_phase(&(ctx)->stats.phase, &(ctx)->stats_mark)
+    #define META_STAT_ADD(ctx, counter, n) ((ctx)->stats.counter += (n))
+    #define META_STAT_INPUT(ctx, data, len) meta_stats_input(ctx, data, len)
+    #define META_STAT_FINISH(ctx, input_file, first) meta_stats_finish(ctx, input_file, first)
+    #define META_STAT_BATCH(ctx, batch) meta_stats_batch(ctx, batch)
+#else
+    #define META_STAT_BEGIN(ctx) ((void)0)
+    #define META_STAT_START(ctx) ((void)0)
+    #define META_STAT_PHASE(ctx, phase) ((void)0)
+    #define META_STAT_ADD(ctx, counter, n) ((void)0)
+    #define META_STAT_INPUT(ctx, data, len) ((void)0)
+    #define META_STAT_FINISH(ctx, input_file, first) ((void)0)
+    #define META_STAT_BATCH(ctx, batch) ((void)0)
+#endif
 
-        return 1;
+#ifdef META_PARSER_STATS
+// Seconds from a monotonic clock, process time where the C library has none
+static double meta_stats_now(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double)count.QuadPart / (double)frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+// Clears the statistics of the previous parse and starts the clock
+static void meta_stats_begin(meta_context *ctx) {
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
+    ctx->stats_mark = meta_stats_now();
+}
+
+// Adds the time since `*mark` to `*phase` and restarts the clock
+static void meta_stats_phase(double *phase, double *mark) {
+    double now = meta_stats_now();
+    *phase += now - *mark;
+    *mark = now;
+}
+
+static void meta_stats_input(meta_context *ctx, const char *data, size_t len) {
+    if (!len) return;
+    size_t lines = 0;
+    const char *p = data, *end = data + len;
+    while (p < end && (p = (const char *)memchr(p, '\n', (size_t)(end - p))) != NULL) {
+        lines++;
+        p++;
     }
-    return 0;
+    if (data[len - 1] != '\n') lines++;
+    ctx->stats.bytes += len;
+    ctx->stats.lines += lines;
 }
 
 /**
- * Parses a single field definition within an object block.
+ * Counts the objects, fields and errors of a finished parse and hands the
+ * statistics to the callback of the context, if it has one.
  *
- * Expected format: "field_name :: field_type"
+ * @param ctx        The parser context.
+ * @param input_file Path of the input, NULL when parsing from memory.
+ * @param first      First object of the parse.
+ */
+static void meta_stats_finish(meta_context *ctx, const char *input_file, const meta_object *first) {
+    meta_stats *stats = &ctx->stats;
+    stats->input_file = input_file;
+    for (const meta_object *obj = first; obj; obj = obj->next) {
+        stats->objects++;
+        stats->fields += (size_t)obj->field_count;
+        if (!obj->valid) {
+            stats->errors++;
+            continue;
+        }
+        for (int i = 0; i < obj->field_count; i++) {
+            if (!obj->fields[i].name_valid || !obj->fields[i].type_valid) stats->errors++;
+        }
+    }
+    if (ctx->stats_callback) ctx->stats_callback(ctx->stats_user, stats);
+}
+#endif
+
+/* -------------------------------- INPUT -------------------------------- */
+
+/**
+ * An input file held in memory as one contiguous buffer, either mapped
+ * straight from disk or read in a single pass.
+ */
+typedef struct meta_source {
+    const char *data;
+    size_t size;
+    int mapped;
+} meta_source;
+
+/**
+ * Reads all of `path` into `src`, memory-mapping it where the platform allows.
  *
- * @param obj  Pointer to the `meta_object` where the field will be stored.
- * @param line Input line containing the field definition.
- * @return 1 if parsing is successful, 0 otherwise.
+ * @param src  Source descriptor to fill in.
+ * @param path Path to the input file.
+ * @return 0 on success, -1 if the file cannot be opened or read.
  */
-static int meta_parse_field(meta_object *obj, const char *line) {
-    if (line != NULL && *line == '#') return 1; // Skip comment lines
+static int meta_source_open(meta_source *src, const char *path) {
+    src->data = NULL;
+    src->size = 0;
+    src->mapped = 0;
 
-    if (obj->field_count >= MAX_FIELDS) {
-        #ifdef META_LOG_CONSOLE
-            fprintf(stderr, "ERROR: Maximum field count exceeded for object '%s'.\n", obj->name);
-        #endif
-        return 0;
+#ifdef META_PARSER_USE_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        if (st.st_size == 0) { close(fd); return 0; }
+        void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            src->data = (const char *)p;
+            src->size = (size_t)st.st_size;
+            src->mapped = 1;
+            close(fd);
+            return 0;
+        }
     }
+    close(fd);  // Not mappable (pipe, device, ...), fall back to reading it
+#endif
 
-    meta_field *field = &obj->fields[obj->field_count];
-    char type[64];
+    FILE *in = fopen(path, "rb");
+    if (!in) return -1;
 
-    if (sscanf(line, "%63s :: %63s", field->name, type) == 2) {
-        if (!_meta_contains(field->name, "!#@$%^&*()-")    && 
-            !_meta_starts_with(field->name, "1234567890") &&
-            !_meta_is_valid_c_type(field->name))
-        {
-            field->name_valid = 1;
+    size_t cap = 4096, len = 0, n;
+    char *buf = (char *)malloc(cap);
+    while (buf && (n = fread(buf + len, 1, cap - len, in)) > 0) {
+        len += n;
+        if (len == cap) {
+            char *grown = (char *)realloc(buf, cap * 2);
+            if (!grown) { free(buf); buf = NULL; break; }
+            buf = grown;
+            cap *= 2;
         }
+    }
+    int failed = ferror(in) || !buf;
+    fclose(in);
+    if (failed) { free(buf); return -1; }
 
-        // Check if the type matches a previously defined object type
-        if (meta_is_object_type(type)) {
-            snprintf(field->type, sizeof(field->type), "%sData", type);
-            field->type_valid = 1;
-        } else {
-            field->type_valid = 0;
-            for (int i = 0; valid_c_types[i] != NULL; i++) {
-                strncpy(field->type, type, sizeof(field->type) - 1);
-                if (_meta_is_valid_c_type(type)) {
-                    field->type[sizeof(field->type) - 1] = '\0';
-                    field->type_valid = 1;
-                    break;
-                };
-            }
-        }
+    src->data = buf;
+    src->size = len;
+    return 0;
+}
 
-        obj->field_count++;
-        return 1;
+/**
+ * Releases a buffer obtained with `meta_source_open`.
+ */
+static void meta_source_close(meta_source *src) {
+#ifdef META_PARSER_USE_MMAP
+    if (src->mapped) {
+        munmap((void *)src->data, src->size);
+        src->data = NULL;
+        return;
+    }
+#endif
+    free((void *)src->data);
+    src->data = NULL;
+}
+
+/* -------------------------------- OUTPUT ------------------------------- */
+
+static int meta_buffer_reserve(meta_buffer *buf, size_t extra) {
+    if (buf->failed) return 0;
+    if (buf->capacity - buf->length > extra) return 1;
+
+    size_t capacity = buf->capacity ? buf->capacity : 4096;
+    while (capacity - buf->length <= extra) capacity *= 2;
+    char *grown = (char *)realloc(buf->data, capacity);
+    if (!grown) { buf->failed = 1; return 0; }
+    buf->data = grown;
+    buf->capacity = capacity;
+    return 1;
+}
+
+/**
+ * Appends formatted text to the buffer, growing it as needed.
+ */
+static void meta_buffer_printf(meta_buffer *buf, const char *fmt, ...) {
+    va_list args;
+    size_t avail = buf->capacity - buf->length;
+    int n;
+
+    va_start(args, fmt);
+    n = avail ? vsnprintf(buf->data + buf->length, avail, fmt, args) : -1;
+    va_end(args);
+
+    if (n >= 0 && (size_t)n < avail) {
+        buf->length += (size_t)n;
+        return;
+    }
+
+    if (n < 0) {  // Nothing reserved yet, measure first
+        va_start(args, fmt);
+        n = vsnprintf(NULL, 0, fmt, args);
+        va_end(args);
+        if (n < 0) return;
     }
+    if (!meta_buffer_reserve(buf, (size_t)n)) return;
 
+    va_start(args, fmt);
+    vsnprintf(buf->data + buf->length, buf->capacity - buf->length, fmt, args);
+    va_end(args);
+    buf->length += (size_t)n;
+}
+
+static int meta_buffer_write(void *user, const char *data, size_t len) {
+    meta_buffer *buf = (meta_buffer *)user;
+    if (!meta_buffer_reserve(buf, len)) return -1;
+    memcpy(buf->data + buf->length, data, len);
+    buf->length += len;
+    buf->data[buf->length] = '\0';
     return 0;
 }
 
 /**
- * Writes a typedef struct for the parsed object to the output file.
- *
- * Example output:
- *     typedef struct ObjectNameData {
- *         type field1;
- *         type field2;
- *     } ObjectNameData;
+ * Returns a sink that appends all output to `buf`, which stays NUL-terminated.
+ * Zero-initialize the buffer before use and release it with `meta_buffer_free`.
  *
- * @param out Pointer to the output file stream.
- * @param obj Pointer to the `meta_object` containing the object and field definitions.
+ * @param buf The buffer to collect output in.
+ * @return A sink writing to `buf`.
  */
-static void meta_write_object(FILE *out, const meta_object *obj) {
-    if (!obj->valid) {
-        if (obj->duplicate) fprintf(out, "// Duplicate object name '%s'\n", obj->name);
-        else fprintf(out, "// Invalid object name '%s'\n", obj->name);
-        fprintf(out, "// typedef struct %sData {\n", obj->name);
-    } else fprintf(out, "typedef struct %sData {\n", obj->name);
-    for (int i = 0; i < obj->field_count; i++) {
-        meta_field field = obj->fields[i];
-        if (!obj->valid) break;
-        if (field.type_valid && field.name_valid) {
-            fprintf(out, "   %s %s;\n", field.type, field.name);
-        } else if (!field.type_valid) {
-            fprintf(
-                out, 
-                "   // %s %s;  // Error: Unresolved or invalid type '%s'\n",
-                field.type, 
-                field.name,
-                field.type
-            );
-            #ifdef META_LOG_CONSOLE
-                fprintf(stderr, "ERROR: Unresolved or invalid type '%s' for field '%s.'\n", field.type,  field.name);
-            #endif
-        } else if (!field.name_valid) {
-            fprintf(
-                out,
-                "   // %s %s;  // Error: Cannot use special characters or numbers in field names.\n",
-                field.type,
-                field.name
-            );
-            #ifdef META_LOG_CONSOLE
-                fprintf(stderr, "ERROR: Cannot use special characters or numbers in field names.\n");
-            #endif
-        }
-    }
-    if (!obj->valid) fprintf(out, "// } %sData;\n\n", obj->name);
-    else fprintf(out, "} %sData;\n\n", obj->name); 
+meta_sink meta_buffer_sink(meta_buffer *buf) {
+    meta_sink sink;
+    sink.write = meta_buffer_write;
+    sink.user = buf;
+    return sink;
+}
 
-    #ifdef META_LOG_CONSOLE
-        if (!obj->valid) {
-            if (obj->duplicate) {
-                fprintf(stderr, "ERROR: Duplicate object name '%s'.\n", obj->name);
-            } else {
-                fprintf(stderr, "ERROR: Invalid object name '%s'.\n", obj->name);
-            };
-        }
-    #endif
+/**
+ * Releases the memory of a buffer and leaves it empty.
+ */
+void meta_buffer_free(meta_buffer *buf) {
+    free(buf->data);
+    memset(buf, 0, sizeof(*buf));
 }
 
 /**
- * Parses a metadata file and generates a corresponding C header file with structs.
+ * Hands everything buffered so far to the sink and empties the buffer.
  *
- * @param input_file  Path to the input metadata file.
- * @param output_file Path to the output C header file.
- * @return 0 on success, -1 if an error occurs (e.g., file cannot be opened).
+ * @return 0 on success, -1 if the buffer or the sink failed.
  */
-int meta_parse(const char *input_file, const char *output_file) {
-    FILE *in = fopen(input_file, "r");
-    if (!in) return -1;
+static int meta_buffer_flush(meta_buffer *buf, const meta_sink *sink) {
+    if (buf->failed) return -1;
+    if (buf->length && sink->write(sink->user, buf->data, buf->length) != 0) return -1;
+    buf->length = 0;
+    return 0;
+}
 
-    FILE *out = fopen(output_file, "w");
-    if (!out) { fclose(in); return -1; }
+/**
+ * Writes `data` to `path` only if the file does not already hold exactly
+ * these bytes, so an unchanged header keeps its modification time. The new
+ * contents go to a temporary file that is then renamed over `path`, so
+ * readers never see a partially written header.
+ *
+ * @param path Path to the output file.
+ * @param data Bytes to write.
+ * @param len  Number of bytes to write.
+ * @return 0 on success (written or already up to date), -1 on failure.
+ */
+static int meta_write_file_if_changed(const char *path, const char *data, size_t len) {
+    meta_source old;
+    if (meta_source_open(&old, path) == 0) {
+        int same = old.size == len && (len == 0 || memcmp(old.data, data, len) == 0);
+        meta_source_close(&old);
+        if (same) return 0;
+    }
 
-    char line[META_PARSER_MAX_LINE];
-    meta_object obj = {0};
-    memset(&obj, 0, sizeof(obj));
-    int in_object = 0;
+    size_t path_len = strlen(path);
+    char *tmp = (char *)malloc(path_len + 5);
+    if (!tmp) return -1;
+    memcpy(tmp, path, path_len);
+    memcpy(tmp + path_len, ".tmp", 5);
 
-    fprintf(out, "/* Auto-generated code - do not edit! */\n\n");
+    FILE *out = fopen(tmp, "wb");
+    if (!out) { free(tmp); return -1; }
+    int failed = fwrite(data, 1, len, out) != len;
+    failed |= fclose(out) != 0;
 
-    while (fgets(line, sizeof(line), in)) {
-        if (meta_trim_line(line)) continue;
+#ifdef _WIN32
+    if (!failed) failed = !MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING);
+#else
+    if (!failed) failed = rename(tmp, path) != 0;
+#endif
+    if (failed) remove(tmp);
+    free(tmp);
+    return failed ? -1 : 0;
+}
 
-        // Start of new object
-        if (strncmp(line, "obj ::", 6) == 0) {
-            // Writeout previous object details
-            if (in_object) {
-                meta_write_object(out, &obj);
-            }
-            memset(&obj, 0, sizeof(obj));
-            in_object = meta_parse_object_start(&obj, line);
-        
-        // End of current object
-        } else if (in_object && strstr(line, "}")) {
-            meta_write_object(out, &obj);
-            in_object = 0;
+/* ----------------------------- DIAGNOSTICS ----------------------------- */
 
-        // Parse fields inside object
-        } else if (in_object) {
-            meta_parse_field(&obj, line);
-        }
+/**
+ * Records a diagnostic in the context. Out of memory, it is dropped.
+ *
+ * @param ctx      The parser context, whose `input_file` is recorded with it.
+ * @param severity META_SEVERITY_*.
+ * @param code     META_DIAG_*.
+ * @param line     Line of the input it refers to, 0 if unknown.
+ * @param column   Column of the input it refers to, 0 if unknown.
+ * @param fmt      printf-style format of the message.
+ */
+static void meta_diagnose(meta_context *ctx, meta_severity severity, meta_diagnostic_code code, int line, int column, const char *fmt, ...) {
+    if (ctx->diagnostic_count == ctx->diagnostic_capacity) {
+        size_t capacity = ctx->diagnostic_capacity ? ctx->diagnostic_capacity * 2 : 16;
+        meta_diagnostic *grown = (meta_diagnostic *)realloc(ctx->diagnostics, capacity * sizeof(meta_diagnostic));
+        if (!grown) return;
+        ctx->diagnostics = grown;
+        ctx->diagnostic_capacity = capacity;
     }
 
-    fclose(in);
-    fclose(out);
-    return 0;  /* Success */
+    char text[256];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    if (len < 0) return;
+    if ((size_t)len >= sizeof(text)) len = (int)sizeof(text) - 1;
+
+    char *message = (char *)meta_arena_alloc(&ctx->arena, (size_t)len + 1);
+    if (!message) return;
+    memcpy(message, text, (size_t)len + 1);
+
+    meta_diagnostic *diag = &ctx->diagnostics[ctx->diagnostic_count++];
+    diag->severity = severity;
+    diag->code = code;
+    diag->file = ctx->input_file;
+    diag->line = line;
+    diag->column = column;
+    diag->message = message;
+}
+
+/**
+ * Reports every object and field starting at `first` that is commented out
+ * in the generated header, in declaration order, and warns about objects
+ * whose `@hot` members spill past one cache line. Runs once the objects are
+ * resolved and laid out, when every error is known.
+ *
+ * @param ctx   The parser context to record the diagnostics in.
+ * @param first First object to check; later objects follow through `next`.
+ */
+static void meta_check_objects(meta_context *ctx, const meta_object *first) {
+    for (const meta_object *obj = first; obj; obj = obj->next) {
+        if (!obj->valid) {
+            meta_intern_entry *entry = obj->duplicate ? meta_intern_entry_for(ctx, obj->name, strlen(obj->name)) : NULL;
+            if (entry && entry->object && entry->object->cold_of) {
+                meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_DUPLICATE_OBJECT, obj->line, obj->column,
+                              "Object name '%s' is taken by the `@cold` companion of object '%s'.", obj->name, entry->object->cold_of->name);
+            } else if (obj->duplicate) {
+                meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_DUPLICATE_OBJECT, obj->line, obj->column,
+                              "Duplicate object name '%s'.", obj->name);
+            } else {
+                meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_INVALID_OBJECT_NAME, obj->line, obj->column,
+                              "Invalid object name '%s'.", obj->name);
+            }
+            continue;
+        }
+
+        // Same order of checks as the comments of `meta_write_object`
+        for (int i = 0; i < obj->field_count; i++) {
+            const meta_field *field = &obj->fields[i];
+            if (field->type_valid && field->name_valid) continue;
+            if (field->bits < 0) {
+                meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_INVALID_BITS, field->line, field->column,
+                              "Invalid bit width or range for field '%s' of type '%s'.", field->name, field->type);
+            } else if (field->cyclic) {
+                meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_CYCLIC_MEMBER, field->line, field->column,
+                              "Field '%s' makes object '%s' contain itself by value.", field->name, obj->name);
+            } else if (!field->type_valid) {
+                meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_UNRESOLVED_TYPE, field->line, field->column,
+                              "Unresolved or invalid type '%s' for field '%s'.", field->type, field->name);
+            } else {
+                meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_INVALID_FIELD_NAME, field->line, field->column,
+                              "Cannot use special characters or numbers in field name '%s'.", field->name);
+            }
+        }
+
+        size_t line = obj->cacheline ? obj->cacheline : META_PARSER_CACHE_LINE;
+        if (obj->hot_size > line) {
+            meta_diagnose(ctx, META_SEVERITY_WARNING, META_DIAG_HOT_SPILL, obj->line, obj->column,
+                          "Hot members of object '%s' take %lu bytes, more than one %lu-byte cache line.",
+                          obj->name, (unsigned long)obj->hot_size, (unsigned long)line);
+        }
+    }
+}
+
+// Writes diagnostics as "file:line:column: error: message" lines with a single write
+static void meta_diagnostics_write(const meta_diagnostic *diags, size_t count, FILE *out) {
+    meta_buffer text;
+    memset(&text, 0, sizeof(text));
+    for (size_t i = 0; i < count; i++) {
+        const meta_diagnostic *diag = &diags[i];
+        meta_buffer_printf(&text, "%s:", diag->file ? diag->file : "<memory>");
+        if (diag->line) meta_buffer_printf(&text, "%d:%d:", diag->line, diag->column);
+        meta_buffer_printf(&text, " %s: %s\n", diag->severity == META_SEVERITY_ERROR ? "error" : "warning", diag->message);
+    }
+    if (text.length) fwrite(text.data, 1, text.length, out);
+    meta_buffer_free(&text);
+}
+
+// With META_LOG_CONSOLE, prints the diagnostics of one parse, those from `start` on, to stderr
+static void meta_diagnostics_log(const meta_context *ctx, size_t start) {
+#ifdef META_LOG_CONSOLE
+    meta_diagnostics_write(ctx->diagnostics + start, ctx->diagnostic_count - start, stderr);
+#else
+    (void)ctx;
+    (void)start;
+#endif
+}
+
+/**
+ * Writes every diagnostic collected by a context, one per line, in a single
+ * write. Messages look like "data.meta:12:5: error: ...".
+ *
+ * @param ctx The parser context.
+ * @param out Stream to write to, e.g. `stderr`.
+ */
+void meta_diagnostics_print(const meta_context *ctx, FILE *out) {
+    meta_diagnostics_write(ctx->diagnostics, ctx->diagnostic_count, out);
+}
+
+/**
+ * Forgets the diagnostics collected by a context. Their messages stay
+ * allocated until the context is freed.
+ *
+ * @param ctx The parser context.
+ */
+void meta_diagnostics_clear(meta_context *ctx) {
+    ctx->diagnostic_count = 0;
+}
+
+/* -------------------------------- LEXER -------------------------------- */
+
+typedef enum meta_token_kind {
+    META_TOK_EOF = 0,
+    META_TOK_NEWLINE,
+    META_TOK_WORD,    // Any run of bytes that is not whitespace, a brace or a colon
+    META_TOK_COLONS,  // "::"
+    META_TOK_COLON,   // ":"
+    META_TOK_LBRACE,
+    META_TOK_RBRACE
+} meta_token_kind;
+
+/**
+ * A token is a slice of the input buffer; nothing is copied while lexing.
+ */
+typedef struct meta_token {
+    meta_token_kind kind;
+    const char *start;
+    size_t len;
+} meta_token;
+
+typedef struct meta_lexer {
+    const char *cur;
+    const char *end;
+    int line;
+    int line_start;  // Only blanks seen since the last newline
+    const char *line_begin;
+} meta_lexer;
+
+static void meta_lexer_init(meta_lexer *lx, const char *src, size_t len) {
+    lx->cur = src;
+    lx->end = src + len;
+    lx->line = 1;
+    lx->line_start = 1;
+    lx->line_begin = src;
+}
+
+static int meta_is_word_char(char c) {
+    switch (c) {
+        case ' ': case '\t': case '\r': case '\n': case '\v': case '\f':
+        case '{': case '}': case ':':
+            return 0;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * Scans the next token in a single pass over the bytes. A `#` that is the first
+ * non-blank character of a line comments out the rest of that line.
+ *
+ * @param lx  Lexer state.
+ * @param tok Receives the token slice.
+ * @return The kind of the scanned token.
+ */
+static meta_token_kind meta_lex(meta_lexer *lx, meta_token *tok) {
+    const char *p = lx->cur;
+    const char *end = lx->end;
+
+    for (;;) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f')) p++;
+        if (p < end && *p == '#' && lx->line_start) {
+            while (p < end && *p != '\n') p++;
+            continue;
+        }
+        break;
+    }
+
+    tok->start = p;
+    tok->len = 1;
+    lx->line_start = 0;
+
+    if (p >= end) {
+        tok->kind = META_TOK_EOF;
+        tok->len = 0;
+    } else if (*p == '\n') {
+        tok->kind = META_TOK_NEWLINE;
+        lx->line++;
+        lx->line_start = 1;
+        lx->line_begin = p + 1;
+    } else if (*p == '{') {
+        tok->kind = META_TOK_LBRACE;
+    } else if (*p == '}') {
+        tok->kind = META_TOK_RBRACE;
+    } else if (*p == ':') {
+        if (p + 1 < end && p[1] == ':') {
+            tok->kind = META_TOK_COLONS;
+            tok->len = 2;
+        } else {
+            tok->kind = META_TOK_COLON;
+        }
+    } else {
+        const char *q = p;
+        while (q < end && meta_is_word_char(*q)) q++;
+        tok->kind = META_TOK_WORD;
+        tok->len = (size_t)(q - p);
+    }
+
+    lx->cur = p + tok->len;
+    return tok->kind;
+}
+
+static meta_token_kind meta_lex_peek(const meta_lexer *lx) {
+    meta_lexer copy = *lx;
+    meta_token tok;
+    return meta_lex(&copy, &tok);
+}
+
+/**
+ * Consumes the remaining tokens of the current line. Stops in front of a `}`
+ * so the caller can still see the end of an object.
+ */
+static void meta_lex_skip_line(meta_lexer *lx) {
+    meta_token tok;
+    for (;;) {
+        meta_token_kind kind = meta_lex_peek(lx);
+        if (kind == META_TOK_EOF || kind == META_TOK_RBRACE) return;
+        meta_lex(lx, &tok);
+        if (kind == META_TOK_NEWLINE) return;
+    }
+}
+
+// Column of a token on the current line, 1-based
+static int meta_token_column(const meta_lexer *lx, const meta_token *tok) {
+    return (int)(tok->start - lx->line_begin) + 1;
+}
+
+static int meta_token_is(const meta_token *tok, const char *text) {
+    return tok->len == strlen(text) && memcmp(tok->start, text, tok->len) == 0;
+}
+
+// Reads a decimal number with optional sign, returns the end or NULL
+static const char *meta_scan_number(const char *p, const char *end, long long *value) {
+    int negative = p < end && *p == '-';
+    const char *digits = p + negative;
+    *value = 0;
+    for (p = digits; p < end && *p >= '0' && *p <= '9' && p - digits < 18; p++) *value = *value * 10 + (*p - '0');
+    if (p == digits) return NULL;
+    if (negative) *value = -*value;
+    return p;
+}
+
+/**
+ * Parses a value range such as "[0..100]" or "[-8..7]".
+ *
+ * @return 1 if the token is a range with `lo <= hi`, 0 otherwise.
+ */
+static int meta_token_range(const meta_token *tok, long long *lo, long long *hi) {
+    const char *p = tok->start, *end = tok->start + tok->len;
+    if (tok->len < 6 || p[0] != '[' || end[-1] != ']') return 0;
+
+    p = meta_scan_number(p + 1, end - 1, lo);
+    if (!p || end - 1 - p < 3 || p[0] != '.' || p[1] != '.') return 0;
+    p = meta_scan_number(p + 2, end - 1, hi);
+    return p == end - 1 && *lo <= *hi;
+}
+
+/**
+ * Scans a field type, which takes every word up to the end of the line, the
+ * first attribute or a bit width, e.g. "unsigned long long" or "float [64]". The words are
+ * joined by single blanks, with none in front of an array length.
+ *
+ * @param lx       Lexer positioned at the type.
+ * @param type     Receives the type, pointing into the input when it is
+ *                 already written that way and into `buf` otherwise.
+ * @param buf      Space for joining the words.
+ * @param capacity Size of `buf`; longer types are returned as written.
+ * @return Number of words scanned, 0 if there is no type.
+ */
+static int meta_lex_type(meta_lexer *lx, meta_token *type, char *buf, size_t capacity) {
+    meta_lexer next = *lx;
+    meta_token tok;
+    const char *end = NULL;
+    size_t len = 0;
+    int words = 0, joined = 0;
+
+    type->kind = META_TOK_WORD;
+    long long lo, hi;
+    while (meta_lex(&next, &tok) == META_TOK_WORD && tok.start[0] != '@' && !meta_token_range(&tok, &lo, &hi)) {
+        int array = tok.start[0] == '[';
+        *lx = next;
+        if (!words++) {
+            type->start = tok.start;
+        } else {
+            if (array || tok.start != end + 1 || end[0] != ' ') joined = 1;
+            if (!array && len < capacity) buf[len] = ' ';
+            if (!array) len++;
+        }
+        if (len + tok.len <= capacity) memcpy(buf + len, tok.start, tok.len);
+        len += tok.len;
+        end = tok.start + tok.len;
+    }
+
+    if (!words) return 0;
+    if (joined && len <= capacity) {
+        type->start = buf;
+        type->len = len;
+    } else {
+        type->len = (size_t)(end - type->start);
+    }
+    return words;
+}
+
+/* ------------------------------- PARSER -------------------------------- */
+
+/**
+ * Allocates a new object in the context arena and registers it under its name.
+ *
+ * @param ctx The parser context.
+ * @param str Start of the object name (need not be NUL-terminated).
+ * @param len Length of the object name in bytes.
+ * @return The new object, or NULL when out of memory.
+ */
+static meta_object *meta_object_create(meta_context *ctx, const char *str, size_t len) {
+    meta_object *obj = (meta_object *)meta_arena_alloc(&ctx->arena, sizeof(*obj));
+    meta_intern_entry *entry = meta_intern_entry_for(ctx, str, len);
+    if (!entry || !obj) {
+        meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_OUT_OF_MEMORY, 0, 0, "Out of memory.");
+        return NULL;
+    }
+    memset(obj, 0, sizeof(*obj));
+    obj->name = entry->str;
+    obj->index = (int)ctx->objects_length;
+
+    META_STAT_ADD(ctx, c_type_lookups, 1);
+    if (!meta_c_name_flags(str, len)) {
+        obj->valid = 1;
+    }
+
+    if (entry->object) {
+        obj->duplicate = 1;
+        obj->valid = 0;
+    } else {
+        entry->object = obj;
+    }
+
+    meta_state_append(ctx, obj);
+    return obj;
+}
+
+typedef struct meta_attribute {
+    const char *name;     // Without the leading `@`
+    unsigned int option;  // META_OPT_* flag the attribute sets on its object
+} meta_attribute;
+
+static const meta_attribute meta_object_attributes[] = {
+    { "serialize",     META_OPT_SERIALIZE },
+    { "reorder",       META_OPT_REORDER },
+    { "assert_layout", META_OPT_ASSERT_LAYOUT },
+    { "soa",           META_OPT_SOA },
+    { "reflect",       META_OPT_REFLECT },
+    { "delta",         META_OPT_DELTA },
+    { "hash",          META_OPT_HASH },
+    { "little_endian", META_OPT_LITTLE_ENDIAN },
+    { "view",          META_OPT_VIEW },
+    { "text",          META_OPT_TEXT },
+    { "cpp",           META_OPT_CPP },
+};
+
+/**
+ * Splits an attribute token such as "@align(32)" into its name and argument.
+ *
+ * @param tok  The token to split.
+ * @param name Receives the name without `@` and argument.
+ * @param arg  Receives the argument, or -1 if there is none or it is not a
+ *             non-negative number.
+ * @return 1 if the token is an attribute, 0 otherwise.
+ */
+static int meta_split_attribute(const meta_token *tok, meta_token *name, long *arg) {
+    if (tok->len < 2 || tok->start[0] != '@') return 0;
+    const char *end = tok->start + tok->len;
+    const char *open = (const char *)memchr(tok->start, '(', tok->len);
+
+    name->kind = META_TOK_WORD;
+    name->start = tok->start + 1;
+    name->len = (size_t)((open ? open : end) - name->start);
+    *arg = -1;
+
+    if (open && end - open > 2 && end[-1] == ')') {
+        long value = 0;
+        const char *p = open + 1;
+        while (p < end - 1 && *p >= '0' && *p <= '9' && value < 1000000000L) value = value * 10 + (*p++ - '0');
+        if (p == end - 1) *arg = value;
+    }
+    return 1;
+}
+
+// Alignments must be powers of two
+static unsigned int meta_parse_align(long arg) {
+    return arg > 0 && arg <= 4096 && (arg & (arg - 1)) == 0 ? (unsigned int)arg : 0;
+}
+
+/**
+ * Parses the attributes between an object name and its opening brace, e.g.
+ * "obj :: Player @serialize @align(64) {". Unknown or invalid attributes are
+ * reported as META_DIAG_UNKNOWN_ATTRIBUTE warnings and otherwise skipped.
+ *
+ * @param ctx The parser context the warnings are recorded in.
+ * @param obj The object the attributes apply to.
+ * @param lx  Lexer positioned just after the object name.
+ */
+static void meta_parse_object_attributes(meta_context *ctx, meta_object *obj, meta_lexer *lx) {
+    meta_token tok, name;
+    long arg;
+    while (meta_lex_peek(lx) == META_TOK_WORD) {
+        meta_lex(lx, &tok);
+        if (!meta_split_attribute(&tok, &name, &arg)) continue;
+
+        size_t i = 0, count = sizeof(meta_object_attributes) / sizeof(meta_object_attributes[0]);
+        while (i < count && !meta_token_is(&name, meta_object_attributes[i].name)) i++;
+        if (i < count) {
+            obj->options |= meta_object_attributes[i].option;
+        } else if (meta_token_is(&name, "align") && meta_parse_align(arg)) {
+            obj->align_request = meta_parse_align(arg);
+        } else if (meta_token_is(&name, "pool") && arg > 0) {
+            obj->pool_capacity = (unsigned int)arg;
+        } else if (meta_token_is(&name, "version") && arg > 0) {
+            obj->version = (unsigned int)arg;
+        } else if (meta_token_is(&name, "cacheline") && (arg < 0 || meta_parse_align(arg))) {
+            obj->cacheline = arg < 0 ? META_PARSER_CACHE_LINE : meta_parse_align(arg);
+        } else {
+            meta_diagnose(ctx, META_SEVERITY_WARNING, META_DIAG_UNKNOWN_ATTRIBUTE, lx->line, meta_token_column(lx, &tok),
+                          "Unknown or invalid attribute '%.*s' on object '%s'.", (int)tok.len, tok.start, obj->name);
+        }
+    }
+}
+
+/**
+ * Parses the start of an object definition and registers the new object. The
+ * lexer is positioned just after "obj ::".
+ *
+ * Expected format: "obj :: ObjectName @attribute... {"
+ *
+ * @param ctx The parser context.
+ * @param lx  Lexer positioned at the object name.
+ * @return The new object, allocated in the context arena, or NULL on failure.
+ */
+static meta_object *meta_parse_object_start(meta_context *ctx, meta_lexer *lx) {
+    meta_token tok;
+    if (meta_lex_peek(lx) != META_TOK_WORD) return NULL;
+    meta_lex(lx, &tok);
+
+    meta_object *obj = meta_object_create(ctx, tok.start, tok.len);
+    if (obj) {
+        obj->line = lx->line;
+        obj->column = meta_token_column(lx, &tok);
+        meta_parse_object_attributes(ctx, obj, lx);
+    }
+    ctx->scratch_count = 0;
+    return obj;
+}
+
+// Copies the collected fields of the given heat into `fields`, in declaration order
+static int meta_collect_fields(const meta_context *ctx, meta_field *fields, int count, int hot) {
+    for (int i = 0; i < ctx->scratch_count; i++) {
+        if (ctx->scratch[i].hot == hot) fields[count++] = ctx->scratch[i];
+    }
+    return count;
+}
+
+// Options of an object that carry over to its `@cold` companion, which is neither versioned nor tracked
+#define META_OPT_COLD (META_OPT_SERIALIZE | META_OPT_REORDER | META_OPT_ASSERT_LAYOUT | META_OPT_REFLECT | META_OPT_HASH | \
+                       META_OPT_LITTLE_ENDIAN | META_OPT_TEXT | META_OPT_CPP)
+
+/**
+ * Registers `<Name>Cold`, the companion object holding the `@cold` members of
+ * `obj`, with the `META_OPT_COLD` options of `obj`. The code generated for
+ * `obj`, its serializer included, then leaves those members out. When an
+ * object of that name already exists the members stay in `obj` as plain ones.
+ *
+ * @return 1 if the companion holds the members, 0 otherwise.
+ */
+static int meta_parse_cold_object(meta_context *ctx, meta_object *obj, int cold) {
+    size_t len = strlen(obj->name);
+    char *name = (char *)malloc(len + 5);
+    if (!name) {
+        meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_OUT_OF_MEMORY, obj->line, obj->column, "Out of memory.");
+        return 0;
+    }
+    memcpy(name, obj->name, len);
+    memcpy(name + len, "Cold", 5);
+    meta_intern_entry *entry = meta_intern_entry_for(ctx, name, len + 4);
+    if (entry && entry->object) {
+        int i = 0;
+        while (ctx->scratch[i].hot >= 0) i++;
+        meta_diagnose(ctx, META_SEVERITY_WARNING, META_DIAG_COLD_COLLISION, ctx->scratch[i].line, ctx->scratch[i].column,
+                      "`@cold` companion '%s' collides with object '%s', keeping the members in '%s'.", name, name, obj->name);
+        free(name);
+        return 0;
+    }
+    meta_object *companion = meta_object_create(ctx, name, len + 4);
+    free(name);
+    if (!companion) return 0;
+
+    companion->options = obj->options & META_OPT_COLD;
+    companion->cold_of = obj;
+    companion->line = obj->line;
+    companion->column = obj->column;
+    companion->fields = (meta_field *)meta_arena_alloc(&ctx->arena, (size_t)cold * sizeof(meta_field));
+    if (companion->fields) companion->field_count = meta_collect_fields(ctx, companion->fields, 0, -1);
+    return 1;
+}
+
+/**
+ * Moves the fields collected for an object into the context arena. `@hot`
+ * members go first, so they share the first cache line, and `@cold` members
+ * move out into a companion object, see `meta_parse_cold_object`.
+ *
+ * @param ctx The parser context.
+ * @param obj The object whose definition just ended.
+ */
+static void meta_parse_object_end(meta_context *ctx, meta_object *obj) {
+    int cold = 0;
+    for (int i = 0; i < ctx->scratch_count; i++) cold += ctx->scratch[i].hot < 0;
+    if (cold && !meta_parse_cold_object(ctx, obj, cold)) {
+        for (int i = 0; i < ctx->scratch_count; i++) {
+            if (ctx->scratch[i].hot < 0) ctx->scratch[i].hot = 0;
+        }
+        cold = 0;
+    }
+
+    size_t size = (size_t)(ctx->scratch_count - cold) * sizeof(meta_field);
+    obj->fields = size ? (meta_field *)meta_arena_alloc(&ctx->arena, size) : NULL;
+    if (obj->fields) {
+        obj->field_count = meta_collect_fields(ctx, obj->fields, meta_collect_fields(ctx, obj->fields, 0, 1), 0);
+    }
+    // Padding the struct to whole lines keeps neighbours in an array off each other's lines
+    if (obj->cacheline > obj->align_request) obj->align_request = obj->cacheline;
+    ctx->scratch_count = 0;
+}
+
+/**
+ * Splits an array type such as "float[64]" into its element type and length.
+ *
+ * @param str   Start of the type as written.
+ * @param len   Length of the type in bytes.
+ * @param count Receives the array length, 0 for anything but a valid array.
+ * @return Length of the element type, or `len` if the type is not an array.
+ */
+static size_t meta_split_array(const char *str, size_t len, int *count) {
+    *count = 0;
+    if (len < 4 || str[len - 1] != ']') return len;
+
+    size_t open = len - 2;
+    while (open > 0 && str[open] >= '0' && str[open] <= '9') open--;
+    if (open == 0 || str[open] != '[' || open == len - 2 || len - open > 11) return len;
+
+    long value = 0;
+    for (size_t i = open + 1; i < len - 1; i++) value = value * 10 + (str[i] - '0');
+    if (value <= 0 || value > 0x7fffffffL) return len;
+
+    *count = (int)value;
+    return open;
+}
+
+/**
+ * Parses the attributes after a field type, e.g. "samples :: float[64] @align(32)".
+ */
+static void meta_parse_field_attributes(meta_context *ctx, const meta_object *obj, meta_field *field, meta_lexer *lx) {
+    meta_token tok, name;
+    long arg;
+    while (meta_lex_peek(lx) == META_TOK_WORD) {
+        meta_lex(lx, &tok);
+        if (!meta_split_attribute(&tok, &name, &arg)) continue;
+
+        if (meta_token_is(&name, "align") && meta_parse_align(arg) && !field->bits) {
+            field->align_request = meta_parse_align(arg);
+        } else if (meta_token_is(&name, "hot") && arg < 0) {
+            field->hot = 1;
+        } else if (meta_token_is(&name, "cold") && arg < 0) {
+            field->hot = -1;
+        } else {
+            meta_diagnose(ctx, META_SEVERITY_WARNING, META_DIAG_UNKNOWN_ATTRIBUTE, lx->line, meta_token_column(lx, &tok),
+                          "Unknown or invalid attribute '%.*s' on field '%s.%s'.", (int)tok.len, tok.start, obj->name, field->name);
+        }
+    }
+}
+
+// Smallest bitfield of the given signedness that holds every value in [lo, hi]
+static int meta_range_bits(long long lo, long long hi, int is_unsigned) {
+    int bits = 1;
+    if (is_unsigned) {
+        if (lo < 0) return -1;
+        while (bits < 63 && (hi >> bits) != 0) bits++;
+    } else {
+        while (bits < 63 && (lo < -(1LL << (bits - 1)) || hi > (1LL << (bits - 1)) - 1)) bits++;
+    }
+    return bits;
+}
+
+/**
+ * Parses an optional bit width after a field type, either explicit as in
+ * "alive :: _Bool : 1" or as the range of values it must hold, as in
+ * "level :: int [0..100]". Only integer types can be bitfields, and the
+ * width must fit the type. An invalid width sets `bits` to -1.
+ *
+ * @param field The field, with its type already set.
+ * @param lx    Lexer positioned just after the type.
+ */
+static void meta_parse_field_bits(meta_field *field, meta_lexer *lx) {
+    meta_token tok;
+    long long lo, hi, width = 0;
+    int flags = meta_c_name_flags(field->type, strlen(field->type));
+
+    if (meta_lex_peek(lx) == META_TOK_COLON) {
+        meta_lex(lx, &tok);
+        if (meta_lex_peek(lx) != META_TOK_WORD) {
+            field->bits = -1;
+            return;
+        }
+        meta_lex(lx, &tok);
+        const char *end = meta_scan_number(tok.start, tok.start + tok.len, &width);
+        if (end != tok.start + tok.len) width = -1;
+    } else if (meta_lex_peek(lx) == META_TOK_WORD) {
+        meta_lexer next = *lx;
+        meta_lex(&next, &tok);
+        if (!meta_token_range(&tok, &lo, &hi)) return;
+        *lx = next;
+        width = meta_range_bits(lo, hi, (flags & META_C_UNSIGNED) != 0);
+    } else {
+        return;
+    }
+
+    const meta_c_name *entry = meta_c_name_find(field->type, strlen(field->type));
+    int limit = entry ? (strcmp(field->type, "_Bool") == 0 ? 1 : (int)entry->size * 8) : 0;
+    int valid = (flags & META_C_INTEGER) && !field->count && width > 0 && width <= limit;
+    field->bits = valid ? (int)width : -1;
+}
+
+/**
+ * Parses a single field definition within an object block.
+ *
+ * Expected format: "field_name :: field_type @attribute...", where the type
+ * may span several words and end in an array length, such as
+ * "unsigned int[64]". Aliases such as `u8` become their C type.
+ *
+ * @param ctx  The parser context. The field is collected in its scratch list.
+ * @param obj  Pointer to the `meta_object` being defined.
+ * @param name The already scanned field name token.
+ * @param lx   Lexer positioned just after the field name.
+ * @return 1 if parsing is successful, 0 otherwise.
+ */
+static int meta_parse_field(meta_context *ctx, meta_object *obj, const meta_token *name, meta_lexer *lx) {
+    meta_token tok;
+    char joined[64];
+    int line = lx->line, column = meta_token_column(lx, name);
+    if (meta_lex_peek(lx) != META_TOK_COLONS) return 0;
+    meta_lex(lx, &tok);
+    if (!meta_lex_type(lx, &tok, joined, sizeof(joined))) return 0;
+
+    if (ctx->scratch_count == ctx->scratch_capacity) {
+        int capacity = ctx->scratch_capacity ? ctx->scratch_capacity * 2 : 16;
+        meta_field *grown = (meta_field *)realloc(ctx->scratch, (size_t)capacity * sizeof(meta_field));
+        if (!grown) {
+            meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_OUT_OF_MEMORY, lx->line, column,
+                          "Out of memory parsing fields of object '%s'.", obj->name);
+            return 0;
+        }
+        ctx->scratch = grown;
+        ctx->scratch_capacity = capacity;
+    }
+
+    meta_field *field = &ctx->scratch[ctx->scratch_count];
+    memset(field, 0, sizeof(*field));
+    field->line = line;
+    field->column = column;
+    size_t type_len = meta_split_array(tok.start, tok.len, &field->count);
+    const char *alias = meta_c_alias(tok.start, type_len);
+    META_STAT_ADD(ctx, c_type_lookups, 1);
+    field->name = meta_intern(ctx, name->start, name->len);
+    field->type = alias ? meta_intern(ctx, alias, strlen(alias)) : meta_intern(ctx, tok.start, type_len);
+    if (!field->name || !field->type) return 0;
+    meta_parse_field_bits(field, lx);
+    meta_parse_field_attributes(ctx, obj, field, lx);
+
+    if (!_meta_contains(field->name, "!#@$%^&*()-")    && 
+        !_meta_starts_with(field->name, "1234567890") &&
+        (META_STAT_ADD(ctx, c_type_lookups, 1), !_meta_is_valid_c_type(field->name)))
+    {
+        field->name_valid = 1;
+    }
+
+    // Object types are resolved once the whole input is known, see `meta_resolve_field`
+    META_STAT_ADD(ctx, c_type_lookups, 1);
+    if ((meta_c_name_flags(tok.start, type_len) & META_C_TYPE) && field->bits >= 0) {
+        field->type_valid = 1;
+    }
+
+    ctx->scratch_count++;
+    return 1;
+}
+
+/**
+ * Resolves a field type against a known object. The object may be declared
+ * anywhere in the input, `meta_sort_objects` later puts the structs in a
+ * compilable order. Invalid objects (e.g. one named `int`) are commented out
+ * in the output, so their name keeps referring to the C type.
+ *
+ * @param field  The field to resolve.
+ * @param target The object named by the field type, or NULL if there is none.
+ * @return 1 if the field now refers to `target`, 0 otherwise.
+ */
+static int meta_resolve_field(meta_field *field, meta_object *target) {
+    if (!target || !target->valid || field->bits < 0) return 0;
+    field->object = target;
+    field->type_valid = 1;
+    return 1;
+}
+
+/**
+ * Resolves the object types of every field, starting at `first`, against the
+ * objects registered in the context. Earlier layouts of versioned objects are
+ * resolved along with them.
+ *
+ * @param ctx   The parser context.
+ * @param first First object to resolve; later objects follow through `next`.
+ */
+static void meta_resolve_objects(meta_context *ctx, meta_object *first) {
+    for (meta_object *obj = first; obj; obj = obj->next) {
+        for (meta_object *layout = obj; layout; layout = layout->prior) {
+            for (int i = 0; i < layout->field_count; i++) {
+                meta_field *field = &layout->fields[i];
+                meta_intern_entry *entry = meta_intern_entry_for(ctx, field->type, strlen(field->type));
+                META_STAT_ADD(ctx, object_lookups, 1);
+                if (entry) meta_resolve_field(field, entry->object);
+            }
+        }
+    }
+}
+
+/**
+ * Writes a typedef struct for the parsed object to the output file.
+ *
+ * Example output:
+ *     typedef struct ObjectNameData {
+ *         type field1;
+ *         type field2;
+ *     } ObjectNameData;
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj Pointer to the `meta_object` containing the object and field definitions.
+ */
+static void meta_write_object(meta_buffer *out, const meta_object *obj) {
+    unsigned int object_align = obj->align_request;
+    if (!obj->valid) {
+        if (obj->duplicate) meta_buffer_printf(out, "// Duplicate object name '%s'\n", obj->name);
+        else meta_buffer_printf(out, "// Invalid object name '%s'\n", obj->name);
+        meta_buffer_printf(out, "// typedef struct %sData {\n", obj->name);
+    } else meta_buffer_printf(out, "typedef struct %sData {\n", obj->name);
+    for (int i = 0; i < obj->field_count; i++) {
+        meta_field field = obj->fields[i];
+        if (!obj->valid) break;
+        char dims[16] = "";
+        if (field.count) snprintf(dims, sizeof(dims), "[%d]", field.count);
+
+        if (field.type_valid && field.name_valid && field.bits) {
+            // Bitfields cannot be aligned, the object alignment moves on to the next member
+            meta_buffer_printf(out, "   %s %s : %d;\n", field.type, field.name, field.bits);
+        } else if (field.type_valid && field.name_valid) {
+            // C cannot align a struct type itself, its first member carries the object alignment
+            unsigned int align = field.align_request > object_align ? field.align_request : object_align;
+            object_align = 0;
+            meta_buffer_printf(out, "   ");
+            if (align) meta_buffer_printf(out, "META_ALIGNAS(%u) ", align);
+            meta_buffer_printf(out, "%s%s %s%s;\n", field.type, field.object ? "Data" : "", field.name, dims);
+        } else if (field.bits < 0) {
+            meta_buffer_printf(
+                out,
+                "   // %s %s%s;  // Error: Invalid bit width or range for type '%s'\n",
+                field.type,
+                field.name,
+                dims,
+                field.type
+            );
+        } else if (field.cyclic) {
+            meta_buffer_printf(
+                out,
+                "   // %sData %s%s;  // Error: Circular by-value member of type '%s'\n",
+                field.type,
+                field.name,
+                dims,
+                field.type
+            );
+        } else if (!field.type_valid) {
+            meta_buffer_printf(
+                out, 
+                "   // %s %s%s;  // Error: Unresolved or invalid type '%s'\n",
+                field.type, 
+                field.name,
+                dims,
+                field.type
+            );
+        } else if (!field.name_valid) {
+            meta_buffer_printf(
+                out,
+                "   // %s%s %s%s;  // Error: Cannot use special characters or numbers in field names.\n",
+                field.type,
+                field.object ? "Data" : "",
+                field.name,
+                dims
+            );
+        }
+    }
+    if (!obj->valid) meta_buffer_printf(out, "// } %sData;\n\n", obj->name);
+    else meta_buffer_printf(out, "} %sData;\n\n", obj->name); 
+}
+
+/**
+ * Tokenizes an in-memory metadata buffer and registers every object in it.
+ *
+ * @param ctx The parser context.
+ * @param src Start of the metadata text (need not be NUL-terminated).
+ * @param len Length of the metadata text in bytes.
+ * @return The first object added by this call, or NULL if there were none.
+ */
+static meta_object *meta_parse_source(meta_context *ctx, const char *src, size_t len) {
+    meta_lexer lx;
+    meta_token tok;
+    meta_object *obj = NULL;
+    meta_object *last = ctx->objects_tail;
+
+    meta_lexer_init(&lx, src, len);
+
+    while (meta_lex(&lx, &tok) != META_TOK_EOF) {
+        if (tok.kind == META_TOK_NEWLINE) continue;
+
+        // Start of new object
+        if (tok.kind == META_TOK_WORD && meta_token_is(&tok, "obj") && meta_lex_peek(&lx) == META_TOK_COLONS) {
+            meta_lex(&lx, &tok);
+            // Finish previous object details
+            if (obj) {
+                meta_parse_object_end(ctx, obj);
+            }
+            obj = meta_parse_object_start(ctx, &lx);
+            meta_lex_skip_line(&lx);
+
+        // End of current object
+        } else if (obj && tok.kind == META_TOK_RBRACE) {
+            meta_parse_object_end(ctx, obj);
+            obj = NULL;
+
+        // Parse fields inside object
+        } else if (obj && tok.kind == META_TOK_WORD) {
+            meta_parse_field(ctx, obj, &tok, &lx);
+            meta_lex_skip_line(&lx);
+
+        } else {
+            meta_lex_skip_line(&lx);
+        }
+    }
+
+    if (obj) {
+        meta_parse_object_end(ctx, obj);
+    }
+
+    return last ? last->next : ctx->objects;
+}
+
+typedef struct meta_sort_frame {
+    size_t node;
+    int field;
+} meta_sort_frame;
+
+/**
+ * Orders the objects starting at `first` so that every object comes after the
+ * objects it holds by value (a depth-first topological sort over the field
+ * types). Objects without dependencies keep their declaration order. A field
+ * that would make an object contain itself, directly or through other objects,
+ * is marked `cyclic` and left unresolved.
+ *
+ * Objects from other inputs or earlier parses are not part of the graph,
+ * they are already defined elsewhere.
+ *
+ * @param first First object to sort; later objects follow through `next`.
+ * @param count Receives the number of objects.
+ * @return Array of the objects in emission order (free with `free`), or NULL
+ *         if there are no objects or memory ran out.
+ */
+static meta_object **meta_sort_objects(meta_object *first, size_t *count) {
+    size_t n = 0;
+    for (meta_object *obj = first; obj; obj = obj->next) n++;
+    *count = 0;
+    if (!n) return NULL;
+
+    meta_object **order = (meta_object **)malloc(n * sizeof(meta_object *));
+    meta_object **nodes = (meta_object **)malloc(n * sizeof(meta_object *));
+    unsigned char *state = (unsigned char *)calloc(n, 1);      // 0 new, 1 on stack, 2 done
+    meta_sort_frame *stack = (meta_sort_frame *)malloc(n * sizeof(meta_sort_frame));
+    if (!order || !nodes || !state || !stack) {
+        free(order); free(nodes); free(state); free(stack);
+        return NULL;
+    }
+
+    size_t base = (size_t)first->index, emitted = 0;
+    for (meta_object *obj = first; obj; obj = obj->next) nodes[(size_t)obj->index - base] = obj;
+
+    for (size_t root = 0; root < n; root++) {
+        if (state[root]) continue;
+        size_t top = 0;
+        stack[top].node = root;
+        stack[top++].field = 0;
+        state[root] = 1;
+
+        while (top) {
+            meta_object *obj = nodes[stack[top - 1].node];
+            int pushed = 0;
+
+            while (obj->valid && stack[top - 1].field < obj->field_count) {
+                meta_field *field = &obj->fields[stack[top - 1].field++];
+                meta_object *dep = field->object;
+                if (!dep || !field->name_valid || dep->file != obj->file) continue;
+
+                size_t at = (size_t)dep->index - base;
+                if ((size_t)dep->index < base || at >= n || nodes[at] != dep) continue;
+
+                if (state[at] == 1) {
+                    field->object = NULL;
+                    field->type_valid = 0;
+                    field->cyclic = 1;
+                } else if (state[at] == 0) {
+                    state[at] = 1;
+                    stack[top].node = at;
+                    stack[top++].field = 0;
+                    pushed = 1;
+                    break;
+                }
+            }
+
+            if (!pushed) {
+                state[stack[top - 1].node] = 2;
+                order[emitted++] = obj;
+                top--;
+            }
+        }
+    }
+
+    free(nodes);
+    free(state);
+    free(stack);
+    *count = n;
+    return order;
+}
+
+/* ------------------------------- CODEGEN ------------------------------- */
+
+// Options that change the generated code of an object
+#define META_OPT_GENERATE  (META_OPT_SERIALIZE | META_OPT_REORDER | META_OPT_ASSERT_LAYOUT | META_OPT_SOA | META_OPT_REFLECT | META_OPT_DELTA | META_OPT_HASH | \
+                            META_OPT_LITTLE_ENDIAN | META_OPT_VIEW | META_OPT_TEXT | META_OPT_CPP)
+// Options an object hands down to the objects it holds by value
+#define META_OPT_INHERITED (META_OPT_SERIALIZE | META_OPT_REFLECT | META_OPT_HASH | META_OPT_LITTLE_ENDIAN | META_OPT_VIEW | \
+                            META_OPT_TEXT | META_OPT_CPP)
+
+// `long double` members, whose value can be shorter than their size
+static int meta_field_long_double(const meta_field *field) {
+    return !field->object && !field->bits && strcmp(field->type, "long double") == 0;
+}
+
+// Members that made it into the struct
+static int meta_field_emitted(const meta_field *field) {
+    return field->name_valid && field->type_valid;
+}
+
+static int meta_object_push(meta_object ***stack, size_t *top, size_t *capacity, meta_object *obj) {
+    if (*top == *capacity) {
+        size_t grown_capacity = *capacity ? *capacity * 2 : 64;
+        meta_object **grown = (meta_object **)realloc(*stack, grown_capacity * sizeof(meta_object *));
+        if (!grown) return -1;
+        *stack = grown;
+        *capacity = grown_capacity;
+    }
+    (*stack)[(*top)++] = obj;
+    return 0;
+}
+
+// Host size and alignment of an emitted member
+static void meta_field_layout(const meta_field *field, size_t *size, size_t *align) {
+    if (field->object) {
+        *size = field->object->size;
+        *align = field->object->align;
+    } else {
+        const meta_c_name *entry = meta_c_name_find(field->type, strlen(field->type));
+        *size = entry ? entry->size : 0;
+        *align = entry && entry->align ? entry->align : 1;
+    }
+    if (field->count) *size *= (size_t)field->count;
+    if (field->align_request > *align) *align = field->align_request;
+}
+
+/**
+ * Moves the members of a META_OPT_REORDER object into decreasing alignment,
+ * which leaves padding only at the end of the struct. Members of equal
+ * alignment keep their declaration order, commented-out fields go last.
+ * `@hot` members are ordered among themselves and stay in front.
+ *
+ * @return 0 on success, -1 when out of memory.
+ */
+static int meta_reorder_fields(meta_object *obj) {
+    size_t n = (size_t)obj->field_count;
+    if (n < 2) return 0;
+
+    meta_field *sorted = (meta_field *)malloc(n * sizeof(meta_field));
+    size_t *aligns = (size_t *)malloc(n * sizeof(size_t));
+    if (!sorted || !aligns) { free(sorted); free(aligns); return -1; }
+
+    for (size_t i = 0; i < n; i++) {
+        size_t size;
+        aligns[i] = 0;
+        if (meta_field_emitted(&obj->fields[i])) meta_field_layout(&obj->fields[i], &size, &aligns[i]);
+    }
+
+    // One stable pass per distinct alignment, largest first, hot members before the rest
+    size_t count = 0;
+    for (int hot = 1; hot >= 0; hot--) {
+        for (size_t bound = (size_t)-1;;) {
+            size_t align = 0;
+            for (size_t i = 0; i < n; i++) {
+                if ((obj->fields[i].hot > 0) == hot && aligns[i] < bound && aligns[i] > align) align = aligns[i];
+            }
+            if (!align) break;
+            for (size_t i = 0; i < n; i++) {
+                if ((obj->fields[i].hot > 0) == hot && aligns[i] == align) sorted[count++] = obj->fields[i];
+            }
+            bound = align;
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!aligns[i]) sorted[count++] = obj->fields[i];
+    }
+
+    memcpy(obj->fields, sorted, n * sizeof(meta_field));
+    free(sorted);
+    free(aligns);
+    return 0;
+}
+
+// FNV-1a, continued from `hash`
+static uint64_t meta_schema_hash(uint64_t hash, const char *text) {
+    for (; *text; text++) hash = (hash ^ (unsigned char)*text) * 1099511628211ull;
+    return hash;
+}
+
+// Hashes what decides the wire layout of an object: member names, types, lengths and nested layouts
+static void meta_schema_object(meta_object *obj) {
+    uint64_t hash = meta_schema_hash(14695981039346656037ull, obj->name);
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        char numbers[48];
+        if (!meta_field_emitted(field)) continue;
+        snprintf(numbers, sizeof(numbers), " %d %d %llu;", field->count, field->bits,
+                 field->object ? (unsigned long long)field->object->schema : 0ull);
+        hash = meta_schema_hash(meta_schema_hash(meta_schema_hash(hash, field->type), " "), field->name);
+        hash = meta_schema_hash(hash, numbers);
+    }
+    obj->schema = hash;
+}
+
+// Lays out an object whose members are all laid out already
+static int meta_layout_object(meta_object *obj) {
+    if (obj->valid && (obj->options & META_OPT_REORDER) && meta_reorder_fields(obj) != 0) return -1;
+
+    size_t size = 0, align = 1;
+    int members = 0, mixed = 0;
+    obj->bitfields = 0;
+    obj->scalar = NULL;
+    obj->hot_size = 0;
+    for (int i = 0; obj->valid && i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        size_t field_size, field_align;
+        if (!meta_field_emitted(field)) continue;
+        // Nested objects count as their scalars, as long as they are byte swapped the same way
+        const char *scalar = field->bits ? NULL : field->type;
+        if (field->object) scalar = field->object->options & META_OPT_LITTLE_ENDIAN ? field->object->scalar : NULL;
+        if (!scalar || (obj->scalar && strcmp(obj->scalar, scalar) != 0)) mixed = 1;
+        obj->scalar = scalar;
+        meta_field_layout(field, &field_size, &field_align);
+        // Bitfields pack in ways C leaves to the compiler, they count as whole members here
+        if (field->bits || (field->object && field->object->bitfields)) obj->bitfields = 1;
+        // The first member that is not a bitfield carries the object alignment, see `meta_write_object`
+        if (!field->bits && !members++ && obj->align_request > field_align) field_align = obj->align_request;
+        size = (size + field_align - 1) / field_align * field_align + field_size;
+        if (field->hot > 0) obj->hot_size = size;
+        if (field_align > align) align = field_align;
+    }
+    if (mixed) obj->scalar = NULL;
+    if (obj->valid && (obj->options & META_OPT_VIEW)) meta_schema_object(obj);
+    obj->size = (size + align - 1) / align * align;
+    obj->align = align;
+    obj->layout = 2;
+    return 0;
+}
+
+typedef struct meta_layout_frame {
+    meta_object *object;
+    int field;
+} meta_layout_frame;
+
+/**
+ * Computes the host size and alignment of every object starting at `first`,
+ * reordering the members of META_OPT_REORDER objects on the way. Members are
+ * laid out before the objects holding them, across inputs in batch mode. A
+ * member that would make an object contain itself is marked `cyclic`, just as
+ * `meta_sort_objects` would.
+ *
+ * @param first First object to lay out; later objects follow through `next`.
+ * @return 0 on success, -1 when out of memory.
+ */
+static int meta_layout_objects(meta_object *first) {
+    meta_layout_frame *stack = NULL;
+    size_t top = 0, capacity = 0;
+
+    for (meta_object *root = first; root; root = root->next) {
+        if (root->layout) continue;
+        meta_object *current = root;
+
+        for (;;) {
+            if (current) {
+                if (top == capacity) {
+                    size_t grown_capacity = capacity ? capacity * 2 : 64;
+                    meta_layout_frame *grown = (meta_layout_frame *)realloc(stack, grown_capacity * sizeof(meta_layout_frame));
+                    if (!grown) { free(stack); return -1; }
+                    stack = grown;
+                    capacity = grown_capacity;
+                }
+                current->layout = 1;
+                stack[top].object = current;
+                stack[top++].field = 0;
+                current = NULL;
+            }
+            if (!top) break;
+
+            meta_layout_frame *frame = &stack[top - 1];
+            meta_object *obj = frame->object;
+            while (obj->valid && frame->field < obj->field_count) {
+                meta_field *field = &obj->fields[frame->field++];
+                meta_object *dep = field->object;
+                if (!dep || !meta_field_emitted(field) || dep->layout == 2) continue;
+
+                if (dep->layout == 1) {
+                    field->object = NULL;
+                    field->type_valid = 0;
+                    field->cyclic = 1;
+                } else {
+                    current = dep;
+                    break;
+                }
+            }
+
+            if (!current) {
+                if (meta_layout_object(obj) != 0) { free(stack); return -1; }
+                top--;
+            }
+        }
+    }
+
+    free(stack);
+    return 0;
+}
+
+/**
+ * Lays out the earlier layouts of every object starting at `first`, once the
+ * current layouts are done. A member naming an object that is not laid out by
+ * now (one only an earlier layout still uses, from another batch input) is
+ * dropped from the earlier layout and starts out zeroed when migrating.
+ *
+ * @return 0 on success, -1 when out of memory.
+ */
+static int meta_layout_priors(meta_object *first) {
+    for (meta_object *obj = first; obj; obj = obj->next) {
+        for (meta_object *prior = obj->prior; prior; prior = prior->prior) {
+            for (int i = 0; i < prior->field_count; i++) {
+                meta_field *field = &prior->fields[i];
+                if (field->object && field->object->layout != 2) {
+                    field->object = NULL;
+                    field->type_valid = 0;
+                }
+            }
+            if (meta_layout_object(prior) != 0) return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Adds the generation options of the context to every object starting at
+ * `first`, then hands inherited options down to the objects they hold by
+ * value, so a serializable object can call the serializers of its members.
+ * Objects written by an earlier parse of the same context are left alone.
+ * Finally lays out the objects, see `meta_layout_objects`, and their earlier
+ * layouts.
+ *
+ * @param first   First object to update; later objects follow through `next`.
+ * @param options META_OPT_* flags of the context.
+ * @return 0 on success, -1 when out of memory.
+ */
+static int meta_apply_options(meta_object *first, unsigned int options) {
+    meta_object **stack = NULL;
+    size_t top = 0, capacity = 0;
+    int base = first ? first->index : 0;
+    int failed = 0;
+
+    for (meta_object *obj = first; obj && !failed; obj = obj->next) {
+        obj->options |= options & META_OPT_GENERATE;
+        // Deltas carry members in the wire format of the serializers
+        if (obj->options & (META_OPT_DELTA | META_OPT_LITTLE_ENDIAN | META_OPT_VIEW)) obj->options |= META_OPT_SERIALIZE;
+        if (obj->options & META_OPT_INHERITED) failed = meta_object_push(&stack, &top, &capacity, obj) != 0;
+    }
+
+    // Options only ever grow, so an object is revisited at most once per inherited flag
+    while (top && !failed) {
+        meta_object *obj = stack[--top];
+        for (int i = 0; obj->valid && i < obj->field_count && !failed; i++) {
+            meta_field *field = &obj->fields[i];
+            meta_object *dep = field->object;
+            if (!dep || !meta_field_emitted(field)) continue;
+            if (dep->file == obj->file && dep->index < base) continue;
+
+            unsigned int missing = obj->options & META_OPT_INHERITED & ~dep->options;
+            if (!missing) continue;
+            dep->options |= missing;
+            failed = meta_object_push(&stack, &top, &capacity, dep) != 0;
+        }
+    }
+
+    free(stack);
+    if (failed || meta_layout_objects(first) != 0) return -1;
+    return meta_layout_priors(first);
+}
+
+/**
+ * Writes the functions shared by every generated text loader: skipping blanks
+ * and comments, and reading names, numbers and strings. Numbers are parsed
+ * by hand, without `strtod` or the locale. Every reader skips leading blanks
+ * and returns the position after what it read, or NULL on malformed input.
+ */
+static void meta_write_text_helpers(meta_buffer *out) {
+    meta_buffer_printf(
+        out,
+        "#ifndef META_TEXT_DEFINED\n"
+        "#define META_TEXT_DEFINED\n"
+        "// 32-bit FNV-1a with a final mix, seeded so the generator can make it a perfect hash over the member names\n"
+        "static inline uint32_t meta_text_hash(const char *s, size_t len, uint32_t seed) {\n"
+        "   uint32_t h = 2166136261u ^ seed;\n"
+        "   for (size_t i = 0; i < len; i++) h = (h ^ (unsigned char)s[i]) * 16777619u;\n"
+        "   h ^= h >> 16;\n"
+        "   h *= 0x85EBCA6Bu;\n"
+        "   return h ^ (h >> 13);\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "// Skips blanks, commas and `#` comments\n"
+        "static inline const char *meta_text_skip(const char *p, const char *end) {\n"
+        "   while (p < end) {\n"
+        "      if (*p == '#') {\n"
+        "         while (p < end && *p != '\\n') p++;\n"
+        "      } else if (*p == ' ' || *p == '\\t' || *p == '\\r' || *p == '\\n' || *p == ',') {\n"
+        "         p++;\n"
+        "      } else {\n"
+        "         break;\n"
+        "      }\n"
+        "   }\n"
+        "   return p;\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "static inline const char *meta_text_expect(const char *p, const char *end, char c) {\n"
+        "   p = meta_text_skip(p, end);\n"
+        "   return p < end && *p == c ? p + 1 : NULL;\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "static inline const char *meta_text_word(const char *p, const char *end, const char **word, size_t *len) {\n"
+        "   p = meta_text_skip(p, end);\n"
+        "   *word = p;\n"
+        "   while (p < end && ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9') || *p == '_')) p++;\n"
+        "   *len = (size_t)(p - *word);\n"
+        "   return *len ? p : NULL;\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "// Skips the object name in front of a `{`, which is optional for nested members\n"
+        "static inline const char *meta_text_name(const char *p, const char *end, const char *name, int required) {\n"
+        "   const char *word;\n"
+        "   size_t len;\n"
+        "   const char *next = meta_text_word(p, end, &word, &len);\n"
+        "   if (!next) return required ? NULL : p;\n"
+        "   return len == strlen(name) && memcmp(word, name, len) == 0 ? next : NULL;\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "static inline const char *meta_text_uint(const char *p, const char *end, unsigned long long *out) {\n"
+        "   const char *digits;\n"
+        "   unsigned long long value = 0;\n"
+        "   p = meta_text_skip(p, end);\n"
+        "   if (p < end && *p == '+') p++;\n"
+        "   for (digits = p; p < end && *p >= '0' && *p <= '9'; p++) {\n"
+        "      unsigned d = (unsigned)(*p - '0');\n"
+        "      if (value > (~0ull - d) / 10) return NULL;\n"
+        "      value = value * 10 + d;\n"
+        "   }\n"
+        "   *out = value;\n"
+        "   return p > digits ? p : NULL;\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "static inline const char *meta_text_int(const char *p, const char *end, long long *out) {\n"
+        "   unsigned long long value;\n"
+        "   p = meta_text_skip(p, end);\n"
+        "   int negative = p < end && *p == '-';\n"
+        "   p = meta_text_uint(p + negative, end, &value);\n"
+        "   if (!p || value > (negative ? 9223372036854775808ull : 9223372036854775807ull)) return NULL;\n"
+        "   *out = negative ? (long long)(0ull - value) : (long long)value;\n"
+        "   return p;\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "// Exact for up to 15 significant digits and exponents within 22, the usual case; within an ulp beyond\n"
+        "static inline const char *meta_text_float(const char *p, const char *end, double *out) {\n"
+        "   static const double powers[23] = {\n"
+        "      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,\n"
+        "      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22\n"
+        "   };\n"
+        "   unsigned long long mantissa = 0;\n"
+        "   int digits = 0, exponent = 0, negative;\n"
+        "   p = meta_text_skip(p, end);\n"
+        "   negative = p < end && *p == '-';\n"
+        "   if (p < end && (*p == '-' || *p == '+')) p++;\n"
+        "   for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) {\n"
+        "      if (mantissa < 100000000000000000ull) mantissa = mantissa * 10 + (unsigned)(*p - '0');\n"
+        "      else exponent++;\n"
+        "   }\n"
+        "   if (p < end && *p == '.') {\n"
+        "      for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) {\n"
+        "         if (mantissa < 100000000000000000ull) {\n"
+        "            mantissa = mantissa * 10 + (unsigned)(*p - '0');\n"
+        "            exponent--;\n"
+        "         }\n"
+        "      }\n"
+        "   }\n"
+        "   if (!digits) return NULL;\n"
+        "   if (p < end && (*p == 'e' || *p == 'E')) {\n"
+        "      long long e;\n"
+        "      p = meta_text_int(p + 1, end, &e);\n"
+        "      if (!p) return NULL;\n"
+        "      exponent += e > 400 ? 400 : e < -400 ? -400 : (int)e;\n"
+        "   }\n"
+        "   double value;\n"
+        "   if (mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22) {\n"
+        "      value = exponent < 0 ? (double)mantissa / powers[-exponent] : (double)mantissa * powers[exponent];\n"
+        "   } else {\n"
+        "      long double x = (long double)mantissa;\n"
+        "      for (; exponent > 22; exponent -= 22) x *= 1e22L;\n"
+        "      for (; exponent < -22; exponent += 22) x /= 1e22L;\n"
+        "      value = (double)(exponent < 0 ? x / powers[-exponent] : x * powers[exponent]);\n"
+        "   }\n"
+        "   *out = negative ? -value : value;\n"
+        "   return p;\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "static inline const char *meta_text_bool(const char *p, const char *end, int *out) {\n"
+        "   const char *word;\n"
+        "   size_t len;\n"
+        "   p = meta_text_word(p, end, &word, &len);\n"
+        "   if (!p) return NULL;\n"
+        "   if ((len == 4 && memcmp(word, \"true\", 4) == 0) || (len == 1 && *word == '1')) *out = 1;\n"
+        "   else if ((len == 5 && memcmp(word, \"false\", 5) == 0) || (len == 1 && *word == '0')) *out = 0;\n"
+        "   else return NULL;\n"
+        "   return p;\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "// A character literal such as 'a', or its number\n"
+        "static inline const char *meta_text_char(const char *p, const char *end, char *out) {\n"
+        "   long long value;\n"
+        "   p = meta_text_skip(p, end);\n"
+        "   if (end - p >= 3 && p[0] == '\\'' && p[2] == '\\'') {\n"
+        "      *out = p[1];\n"
+        "      return p + 3;\n"
+        "   }\n"
+        "   p = meta_text_int(p, end, &value);\n"
+        "   if (p) *out = (char)value;\n"
+        "   return p;\n"
+        "}\n\n"
+    );
+    meta_buffer_printf(
+        out,
+        "// A string in double quotes with \\\" and \\\\ escapes, cut to fit and NUL-terminated when there is room\n"
+        "static inline const char *meta_text_string(const char *p, const char *end, char *dst, size_t capacity) {\n"
+        "   size_t n = 0;\n"
+        "   p = meta_text_expect(p, end, '\"');\n"
+        "   while (p && p < end && *p != '\"') {\n"
+        "      if (*p == '\\\\' && p + 1 < end) p++;\n"
+        "      if (n < capacity) dst[n++] = *p;\n"
+        "      p++;\n"
+        "   }\n"
+        "   if (!p || p == end) return NULL;\n"
+        "   if (n < capacity) dst[n] = '\\0';\n"
+        "   return p + 1;\n"
+        "}\n"
+        "#endif\n\n"
+    );
+}
+
+/**
+ * Writes the system includes the generated functions of `order` rely on.
+ */
+static void meta_write_prelude(meta_buffer *out, meta_object **order, size_t count) {
+    unsigned int options = 0;
+    int aligned = 0, stdint = 0, pools = 0, migrations = 0, bools = 0, long_doubles = 0;
+    for (size_t i = 0; i < count; i++) {
+        const meta_object *obj = order[i];
+        if (!obj->valid) continue;
+        options |= obj->options;
+        aligned |= obj->align_request != 0 || obj->pool_capacity != 0;
+        stdint |= obj->pool_capacity != 0;
+        pools |= obj->pool_capacity != 0;
+        migrations |= obj->prior != NULL;
+        for (const meta_object *layout = obj; layout; layout = layout->prior) {
+            aligned |= layout->align_request != 0;
+            for (int f = 0; f < layout->field_count; f++) {
+                const meta_field *field = &layout->fields[f];
+                if (!meta_field_emitted(field)) continue;
+                aligned |= field->align_request != 0;
+                bools |= strcmp(field->type, "_Bool") == 0;
+                long_doubles |= (obj->options & META_OPT_HASH) && meta_field_long_double(field);
+                stdint |= !field->object && (meta_c_name_flags(field->type, strlen(field->type)) & META_C_STDINT);
+            }
+        }
+    }
+
+    int asserts = (options & (META_OPT_REORDER | META_OPT_ASSERT_LAYOUT)) != 0;
+    int stddef = asserts || migrations || (options & (META_OPT_SERIALIZE | META_OPT_SOA | META_OPT_REFLECT | META_OPT_HASH | META_OPT_TEXT | META_OPT_CPP));
+    stdint |= (options & (META_OPT_HASH | META_OPT_LITTLE_ENDIAN | META_OPT_VIEW | META_OPT_TEXT)) != 0;
+    int includes = stddef || stdint;
+    if (stddef) meta_buffer_printf(out, "#include <stddef.h>\n");
+    if (stdint) meta_buffer_printf(out, "#include <stdint.h>\n");
+    if (long_doubles) meta_buffer_printf(out, "#include <float.h>\n");
+    if (options & META_OPT_SOA) meta_buffer_printf(out, "#include <stdlib.h>\n");
+    if ((options & (META_OPT_SERIALIZE | META_OPT_SOA | META_OPT_HASH | META_OPT_TEXT)) || pools || migrations) meta_buffer_printf(out, "#include <string.h>\n");
+    if (includes) meta_buffer_printf(out, "\n");
+    if (bools) {
+        meta_buffer_printf(
+            out,
+            "#if defined(__cplusplus) && !defined(_Bool)\n"
+            "#define _Bool bool  // Same layout, C++ only knows it under this name\n"
+            "#endif\n\n"
+        );
+    }
+    if (asserts) {
+        meta_buffer_printf(
+            out,
+            "#ifndef META_STATIC_ASSERT\n"
+            "#ifdef __cplusplus\n"
+            "#define META_STATIC_ASSERT(cond, msg) static_assert(cond, msg)\n"
+            "#else\n"
+            "#define META_STATIC_ASSERT(cond, msg) _Static_assert(cond, msg)\n"
+            "#endif\n"
+            "#endif\n\n"
+        );
+    }
+    if (aligned) {
+        meta_buffer_printf(
+            out,
+            "#ifndef META_ALIGNAS\n"
+            "#ifdef __cplusplus\n"
+            "#define META_ALIGNAS(n) alignas(n)\n"
+            "#else\n"
+            "#define META_ALIGNAS(n) _Alignas(n)\n"
+            "#endif\n"
+            "#endif\n\n"
+        );
+    }
+    if (options & META_OPT_REFLECT) {
+        meta_buffer_printf(
+            out,
+            "#ifndef META_FIELD_INFO_DEFINED\n"
+            "#define META_FIELD_INFO_DEFINED\n"
+            "typedef enum meta_type_id {\n"
+            "   META_TYPE_OTHER,\n"
+            "   META_TYPE_BOOL,\n"
+            "   META_TYPE_CHAR,\n"
+            "   META_TYPE_INT,\n"
+            "   META_TYPE_UINT,\n"
+            "   META_TYPE_FLOAT,\n"
+            "   META_TYPE_OBJECT\n"
+            "} meta_type_id;\n\n"
+            "typedef struct meta_field_info {\n"
+            "   const char *name;\n"
+            "   const char *type;\n"
+            "   meta_type_id type_id;\n"
+            "   size_t offset;  // Not meaningful for bitfields\n"
+            "   size_t size;    // Of one element\n"
+            "   size_t count;   // Array length, 0 for a single value\n"
+            "   int bits;       // Bitfield width, 0 for a plain member\n"
+            "   const struct meta_field_info *fields;  // Members of a META_TYPE_OBJECT with a table\n"
+            "   size_t field_count;\n"
+            "} meta_field_info;\n"
+            "#endif\n\n"
+        );
+    }
+    if (options & (META_OPT_REFLECT | META_OPT_CPP)) {
+        meta_buffer_printf(
+            out,
+            "#if defined(__cplusplus) && !defined(META_CONSTEXPR)\n"
+            "#if __cplusplus >= 201402L\n"
+            "#define META_CONSTEXPR constexpr\n"
+            "#else\n"
+            "#define META_CONSTEXPR inline\n"
+            "#endif\n"
+            "#endif\n\n"
+        );
+    }
+    if (options & META_OPT_CPP) {
+        meta_buffer_printf(
+            out,
+            "#if defined(__cplusplus) && !defined(META_SCHEMA_DEFINED)\n"
+            "#define META_SCHEMA_DEFINED\n"
+            "namespace meta {\n"
+            "// Specialized for the struct of every object generated with META_OPT_CPP\n"
+            "template <typename T> struct schema;\n\n"
+            "// Picks a member descriptor, as in `schema<T>::member(index<0>())`\n"
+            "template <size_t I> struct index {};\n\n"
+            "// Compile-time description of one member, `v.*member` is that member of `v`\n"
+            "template <typename T, typename M>\n"
+            "struct field {\n"
+            "   typedef M type;\n"
+            "   const char *name;\n"
+            "   M T::*member;\n"
+            "   size_t offset;\n"
+            "};\n\n"
+            "template <typename T, typename F>\n"
+            "META_CONSTEXPR void visit(T &v, F &&f) { schema<T>::visit(v, f); }\n"
+            "template <typename T, typename F>\n"
+            "META_CONSTEXPR void visit(const T &v, F &&f) { schema<T>::visit(v, f); }\n"
+            "template <typename Archive, typename T>\n"
+            "inline void serialize(Archive &ar, T &v) { schema<T>::serialize(ar, v); }\n"
+            "}\n"
+            "#endif\n\n"
+        );
+    }
+    if (options & META_OPT_LITTLE_ENDIAN) {
+        // Byte swaps only ever run on big-endian hosts, 16 bytes at a time where SIMD is available
+        meta_buffer_printf(
+            out,
+            "#ifndef META_LE_DEFINED\n"
+            "#define META_LE_DEFINED\n"
+            "#ifndef META_BIG_ENDIAN\n"
+            "#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__\n"
+            "#define META_BIG_ENDIAN 1\n"
+            "#else\n"
+            "#define META_BIG_ENDIAN 0\n"
+            "#endif\n"
+            "#endif\n\n"
+            "#if defined(__SSSE3__)\n"
+            "#include <tmmintrin.h>\n"
+            "#elif defined(__ARM_NEON)\n"
+            "#include <arm_neon.h>\n"
+            "#endif\n\n"
+            "// Copies `count` elements of `size` bytes, reversing the bytes of each; dst and src must not overlap\n"
+            "static inline void meta_copy_swap(void *dst, const void *src, size_t count, size_t size) {\n"
+            "   unsigned char *d = (unsigned char *)dst;\n"
+            "   const unsigned char *s = (const unsigned char *)src;\n"
+            "   size_t i = 0, bytes = count * size;\n"
+            "#if defined(__SSSE3__)\n"
+            "   if (size == 2 || size == 4 || size == 8) {\n"
+            "      __m128i mask = size == 2 ? _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)\n"
+            "                   : size == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)\n"
+            "                   : _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);\n"
+            "      for (; i + 16 <= bytes; i += 16) {\n"
+            "         _mm_storeu_si128((__m128i *)(d + i), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(s + i)), mask));\n"
+            "      }\n"
+            "   }\n"
+            "#elif defined(__ARM_NEON)\n"
+            "   if (size == 2 || size == 4 || size == 8) {\n"
+            "      for (; i + 16 <= bytes; i += 16) {\n"
+            "         uint8x16_t x = vld1q_u8(s + i);\n"
+            "         vst1q_u8(d + i, size == 2 ? vrev16q_u8(x) : size == 4 ? vrev32q_u8(x) : vrev64q_u8(x));\n"
+            "      }\n"
+            "   }\n"
+            "#endif\n"
+            "   if (size == 4) {\n"
+            "      for (; i < bytes; i += 4) {\n"
+            "         uint32_t x;\n"
+            "         memcpy(&x, s + i, 4);\n"
+            "         x = (x >> 24) | ((x >> 8) & 0xff00u) | ((x << 8) & 0xff0000u) | (x << 24);\n"
+            "         memcpy(d + i, &x, 4);\n"
+            "      }\n"
+            "   }\n"
+            "   for (; i < bytes; i += size) {\n"
+            "      for (size_t b = 0; b < size; b++) d[i + b] = s[i + size - 1 - b];\n"
+            "   }\n"
+            "}\n\n"
+            "// Copies `count` elements of `size` bytes between host and little-endian order\n"
+            "static inline void meta_le_copy(void *dst, const void *src, size_t count, size_t size) {\n"
+            "   if (!META_BIG_ENDIAN || size == 1) {\n"
+            "      if (count) memcpy(dst, src, count * size);\n"
+            "   } else {\n"
+            "      meta_copy_swap(dst, src, count, size);\n"
+            "   }\n"
+            "}\n"
+            "#endif\n\n"
+        );
+    }
+    if (options & META_OPT_VIEW) {
+        meta_buffer_printf(
+            out,
+            "#ifndef META_VIEW_DEFINED\n"
+            "#define META_VIEW_DEFINED\n"
+            "#define META_VIEW_MAGIC 0x5745564Du  // \"MVEW\"\n"
+            "#define META_VIEW_HEADER_SIZE 24     // Magic, format version, schema hash, record count\n"
+            "#define META_VIEW_FORMAT 1u\n"
+            "#endif\n\n"
+        );
+    }
+    if (options & META_OPT_TEXT) {
+        meta_write_text_helpers(out);
+    }
+    if (options & META_OPT_HASH) {
+        // Eight bytes per multiply-xorshift round, in the spirit of wyhash and xxh3
+        meta_buffer_printf(
+            out,
+            "#ifndef META_HASH_DEFINED\n"
+            "#define META_HASH_DEFINED\n"
+            "static inline uint64_t meta_hash_mix(uint64_t h, uint64_t v) {\n"
+            "   h ^= v * 0x9E3779B97F4A7C15ull;\n"
+            "   h = (h ^ (h >> 32)) * 0xD6E8FEB86659FD93ull;\n"
+            "   return h ^ (h >> 32);\n"
+            "}\n\n"
+            "static inline uint64_t meta_hash_block(const void *data, size_t len, uint64_t h) {\n"
+            "   const unsigned char *p = (const unsigned char *)data;\n"
+            "   uint64_t v;\n"
+            "   for (; len >= 8; p += 8, len -= 8) {\n"
+            "      memcpy(&v, p, 8);\n"
+            "      h = meta_hash_mix(h, v);\n"
+            "   }\n"
+            "   v = 0;\n"
+            "   if (len) memcpy(&v, p, len);\n"
+            "   return meta_hash_mix(h, v ^ ((uint64_t)len << 56));\n"
+            "}\n"
+            "#endif\n\n"
+        );
+    }
+    if (long_doubles) {
+        // x87 extended precision keeps its 80 bits in the first 10 bytes, the rest is padding
+        meta_buffer_printf(
+            out,
+            "#ifndef META_LDBL_BYTES\n"
+            "#if LDBL_MANT_DIG == 64 && (defined(__i386__) || defined(__x86_64__))\n"
+            "#define META_LDBL_BYTES 10\n"
+            "#else\n"
+            "#define META_LDBL_BYTES sizeof(long double)\n"
+            "#endif\n"
+            "#endif\n\n"
+        );
+    }
+}
+
+/**
+ * Writes static asserts pinning the size of a struct and the offset of every
+ * member to the layout computed by `meta_layout_objects`, so a compiler or
+ * platform that lays the struct out differently fails the build.
+ *
+ * Example output:
+ *     META_STATIC_ASSERT(sizeof(ObjectNameData) == 16, "ObjectNameData layout");
+ *     META_STATIC_ASSERT(offsetof(ObjectNameData, field1) == 0, "ObjectNameData layout");
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid, laid out object.
+ */
+static void meta_write_layout_asserts(meta_buffer *out, const meta_object *obj) {
+    size_t offset = 0;
+    int members = 0;
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        size_t size, align;
+        if (!meta_field_emitted(field)) continue;
+        // Bitfield packing is up to the compiler, nothing from the first one on can be checked
+        if (field->bits) break;
+        meta_field_layout(field, &size, &align);
+        offset = (offset + align - 1) / align * align;
+        if (!members++ && !obj->bitfields) {
+            meta_buffer_printf(out, "META_STATIC_ASSERT(sizeof(%sData) == %lu, \"%sData layout\");\n", obj->name, (unsigned long)obj->size, obj->name);
+        }
+        meta_buffer_printf(
+            out,
+            "META_STATIC_ASSERT(offsetof(%sData, %s) == %lu, \"%sData layout\");\n",
+            obj->name,
+            field->name,
+            (unsigned long)offset,
+            obj->name
+        );
+        if (field->object && field->object->bitfields) break;
+        offset += size;
+    }
+    if (members) meta_buffer_printf(out, "\n");
+}
+
+// Nested members of an object from an earlier parse are copied as raw bytes
+static int meta_field_serializable(const meta_field *field) {
+    return field->object && (field->object->options & META_OPT_SERIALIZE);
+}
+
+// Whether `XData_WIRE_SIZE` of a serialized object is the constant 0, as without emitted members
+static int meta_wire_size_empty(const meta_object *obj) {
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (meta_field_emitted(field) && (!meta_field_serializable(field) || !meta_wire_size_empty(field->object))) return 0;
+    }
+    return 1;
+}
+
+// Writes the wire size of one element of a member
+static void meta_write_wire_size(meta_buffer *out, const meta_field *field) {
+    if (meta_field_serializable(field)) meta_buffer_printf(out, "%sData_WIRE_SIZE", field->type);
+    else meta_buffer_printf(out, "sizeof(%s%s)", field->type, field->object ? "Data" : "");
+}
+
+// Writes the statement that moves one member between `v` and `buf + n`, then advances `n`
+static void meta_write_field_io(meta_buffer *out, const meta_field *field, int reading, int little, const char *indent) {
+    const char *verb = reading ? "read" : "write";
+    little = little && !field->object;
+    if (little && field->bits) {
+        meta_buffer_printf(
+            out,
+            reading ? "%s{ %s t; meta_le_copy(&t, buf + n, 1, sizeof(t)); v->%s = t; } n += sizeof(%s);\n"
+                    : "%s{ %s t = v->%s; meta_le_copy(buf + n, &t, 1, sizeof(t)); } n += sizeof(%s);\n",
+            indent, field->type, field->name, field->type
+        );
+    } else if (little) {
+        const char *at = field->count ? "" : "&";
+        const char *element = field->count ? "[0]" : "";
+        meta_buffer_printf(out, "%smeta_le_copy(", indent);
+        if (reading) meta_buffer_printf(out, "%sv->%s, buf + n", at, field->name);
+        else meta_buffer_printf(out, "buf + n, %sv->%s", at, field->name);
+        meta_buffer_printf(out, ", %d, sizeof(v->%s%s)); n += sizeof(v->%s);\n", field->count ? field->count : 1, field->name, element, field->name);
+    } else if (meta_field_serializable(field) && field->count) {
+        meta_buffer_printf(out, "%sn += %sData_%s_array(buf + n, v->%s, %d);\n", indent, field->type, verb, field->name, field->count);
+    } else if (meta_field_serializable(field)) {
+        meta_buffer_printf(out, "%sn += %sData_%s(buf + n, &v->%s);\n", indent, field->type, verb, field->name);
+    } else if (field->bits) {
+        // A bitfield has no address, it goes through a value of its type
+        meta_buffer_printf(
+            out,
+            reading ? "%s{ %s t; memcpy(&t, buf + n, sizeof(t)); v->%s = t; } n += sizeof(%s);\n"
+                    : "%s{ %s t = v->%s; memcpy(buf + n, &t, sizeof(t)); } n += sizeof(%s);\n",
+            indent, field->type, field->name, field->type
+        );
+    } else {
+        meta_buffer_printf(
+            out,
+            reading ? "%smemcpy(&v->%s, buf + n, sizeof(v->%s)); n += sizeof(v->%s);\n"
+                    : "%smemcpy(buf + n, &v->%s, sizeof(v->%s)); n += sizeof(v->%s);\n",
+            indent, field->name, field->name, field->name
+        );
+    }
+}
+
+/**
+ * Writes `XData_write` and `XData_read`, which store the emitted members in
+ * declaration order without padding, plus bulk versions for arrays of
+ * records. When the struct has no padding at all the wire layout equals the
+ * host layout and every function collapses to a single `memcpy`. Bitfields
+ * take the full size of their type on the wire and rule out the `memcpy`.
+ *
+ * With META_OPT_LITTLE_ENDIAN every scalar is stored little-endian through
+ * `meta_le_copy`, which is a `memcpy` on little-endian hosts and a byte swap
+ * on big-endian ones. If all scalars of a record share one type (e.g. a
+ * vector of floats), whole records and arrays are swapped as one block.
+ *
+ * Example output:
+ *     #define ObjectNameData_WIRE_SIZE (sizeof(int) + OtherData_WIRE_SIZE)
+ *     static inline size_t ObjectNameData_write(unsigned char *buf, const ObjectNameData *v);
+ *     static inline size_t ObjectNameData_read(const unsigned char *buf, ObjectNameData *v);
+ *     static inline size_t ObjectNameData_write_array(unsigned char *buf, const ObjectNameData *v, size_t count);
+ *     static inline size_t ObjectNameData_read_array(const unsigned char *buf, ObjectNameData *v, size_t count);
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid object with META_OPT_SERIALIZE set.
+ */
+static void meta_write_serializers(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    const char *scalar = obj->scalar;
+    int little = (obj->options & META_OPT_LITTLE_ENDIAN) != 0;
+    int members = 0;
+    // Without a common scalar type, a byte swapping host has to go member by member
+    const char *host = little && !scalar ? "!META_BIG_ENDIAN && " : "";
+
+    meta_buffer_printf(out, "#define %sData_WIRE_SIZE (", name);
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        if (members++) meta_buffer_printf(out, " + ");
+        if (field->count) meta_buffer_printf(out, "%d * ", field->count);
+        meta_write_wire_size(out, field);
+    }
+    meta_buffer_printf(out, "%s)\n\n", members ? "" : "0");
+
+    for (int reading = 0; reading < 2; reading++) {
+        const char *verb = reading ? "read" : "write";
+        meta_buffer_printf(
+            out,
+            reading ? "static inline size_t %sData_%s(const unsigned char *buf, %sData *v) {\n"
+                    : "static inline size_t %sData_%s(unsigned char *buf, const %sData *v) {\n",
+            name, verb, name
+        );
+        if (!obj->bitfields) {
+            meta_buffer_printf(out, "   if (%ssizeof(%sData) == %sData_WIRE_SIZE) {\n", host, name, name);
+            if (little && scalar) {
+                meta_buffer_printf(out, "      meta_le_copy(%s, sizeof(%sData) / sizeof(%s), sizeof(%s));\n", reading ? "v, buf" : "buf, v", name, scalar, scalar);
+            } else {
+                meta_buffer_printf(out, reading ? "      memcpy(v, buf, sizeof(%sData));\n" : "      memcpy(buf, v, sizeof(%sData));\n", name);
+            }
+            meta_buffer_printf(out, "      return sizeof(%sData);\n   }\n", name);
+        }
+        meta_buffer_printf(out, "   size_t n = 0;\n");
+        for (int i = 0; i < obj->field_count; i++) {
+            if (meta_field_emitted(&obj->fields[i])) meta_write_field_io(out, &obj->fields[i], reading, little, "   ");
+        }
+        meta_buffer_printf(out, "   return n;\n}\n\n");
+    }
+
+    for (int reading = 0; reading < 2; reading++) {
+        const char *verb = reading ? "read" : "write";
+        meta_buffer_printf(
+            out,
+            reading ? "static inline size_t %sData_%s_array(const unsigned char *buf, %sData *v, size_t count) {\n"
+                    : "static inline size_t %sData_%s_array(unsigned char *buf, const %sData *v, size_t count) {\n",
+            name, verb, name
+        );
+        if (!obj->bitfields) {
+            meta_buffer_printf(out, "   if (%ssizeof(%sData) == %sData_WIRE_SIZE) {\n", host, name, name);
+            if (little && scalar) {
+                meta_buffer_printf(
+                    out,
+                    "      meta_le_copy(%s, count * (sizeof(%sData) / sizeof(%s)), sizeof(%s));\n",
+                    reading ? "v, buf" : "buf, v", name, scalar, scalar
+                );
+            } else {
+                meta_buffer_printf(out, "      if (count) memcpy(%s, count * sizeof(%sData));\n", reading ? "v, buf" : "buf, v", name);
+            }
+            meta_buffer_printf(out, "      return count * sizeof(%sData);\n   }\n", name);
+        }
+        meta_buffer_printf(out, "   size_t n = 0;\n");
+        meta_buffer_printf(out, "   for (size_t i = 0; i < count; i++) n += %sData_%s(buf + n, &v[i]);\n", name, verb);
+        meta_buffer_printf(out, "   return n;\n}\n\n");
+    }
+}
+
+/**
+ * Writes `XDataView`, a read-only view of one record in a buffer written by
+ * `XData_write`, and an accessor per member that reads it in place from its
+ * fixed offset. Nested objects come back as views of their own, arrays take
+ * an index. A file of records starts with a header, written by
+ * `XData_write_view_header`, that `XData_open_view` checks against the
+ * schema hash of the object before handing out a view of the first record.
+ *
+ * Example output:
+ *     #define ObjectNameData_SCHEMA 0x1234abcd5678ef90ull
+ *     #define ObjectNameData_OFFSET_field1 0
+ *     #define ObjectNameData_OFFSET_field2 (ObjectNameData_OFFSET_field1 + sizeof(int))
+ *     typedef struct ObjectNameDataView {
+ *        const unsigned char *data;
+ *     } ObjectNameDataView;
+ *     static inline int ObjectNameDataView_field1(ObjectNameDataView v);
+ *     static inline OtherDataView ObjectNameDataView_field2(ObjectNameDataView v);
+ *
+ * followed by `_at`, `_write_view_header` and `_open_view`.
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid object with META_OPT_VIEW and META_OPT_SERIALIZE set.
+ */
+static void meta_write_view(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    int little = (obj->options & META_OPT_LITTLE_ENDIAN) != 0;
+    const meta_field *previous = NULL;
+
+    meta_buffer_printf(out, "#define %sData_SCHEMA 0x%016llxull\n", name, (unsigned long long)obj->schema);
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        meta_buffer_printf(out, "#define %sData_OFFSET_%s ", name, field->name);
+        if (!previous) {
+            meta_buffer_printf(out, "0\n");
+        } else {
+            meta_buffer_printf(out, "(%sData_OFFSET_%s + ", name, previous->name);
+            if (previous->count) meta_buffer_printf(out, "%d * ", previous->count);
+            meta_write_wire_size(out, previous);
+            meta_buffer_printf(out, ")\n");
+        }
+        previous = field;
+    }
+    meta_buffer_printf(out, "\ntypedef struct %sDataView {\n   const unsigned char *data;\n} %sDataView;\n\n", name, name);
+    meta_buffer_printf(
+        out,
+        "static inline %sDataView %sDataView_at(const unsigned char *records, size_t index) {\n"
+        "   %sDataView v;\n"
+        "   v.data = records + index * %sData_WIRE_SIZE;\n"
+        "   return v;\n"
+        "}\n\n",
+        name, name, name, name
+    );
+
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        int view = field->object && (field->object->options & META_OPT_VIEW);
+        const char *suffix = view ? "DataView" : field->object ? "Data" : "";
+
+        meta_buffer_printf(out, "static inline %s%s %sDataView_%s(%sDataView v%s) {\n", field->type, suffix, name, field->name, name, field->count ? ", size_t i" : "");
+        meta_buffer_printf(out, "   %s%s r;\n   ", field->type, suffix);
+        if (view) meta_buffer_printf(out, "r.data = ");
+        else if (meta_field_serializable(field)) meta_buffer_printf(out, "%sData_read(", field->type);
+        else if (little && !field->object) meta_buffer_printf(out, "meta_le_copy(&r, ");
+        else meta_buffer_printf(out, "memcpy(&r, ");
+
+        // Elements of an array follow each other at their wire size
+        meta_buffer_printf(out, "v.data + %sData_OFFSET_%s", name, field->name);
+        if (field->count) {
+            meta_buffer_printf(out, " + i * ");
+            meta_write_wire_size(out, field);
+        }
+
+        if (view) meta_buffer_printf(out, ";\n");
+        else if (meta_field_serializable(field)) meta_buffer_printf(out, ", &r);\n");
+        else if (little && !field->object) meta_buffer_printf(out, ", 1, sizeof(r));\n");
+        else meta_buffer_printf(out, ", sizeof(r));\n");
+        meta_buffer_printf(out, "   return r;\n}\n\n");
+    }
+
+    meta_buffer_printf(
+        out,
+        "static inline size_t %sData_write_view_header(unsigned char *buf, uint64_t count) {\n"
+        "   uint32_t words[2] = { META_VIEW_MAGIC, META_VIEW_FORMAT };\n"
+        "   uint64_t schema = %sData_SCHEMA;\n",
+        name, name
+    );
+    meta_buffer_printf(
+        out,
+        little ? "   meta_le_copy(buf, words, 2, sizeof(uint32_t));\n"
+                 "   meta_le_copy(buf + 8, &schema, 1, sizeof(schema));\n"
+                 "   meta_le_copy(buf + 16, &count, 1, sizeof(count));\n"
+               : "   memcpy(buf, words, sizeof(words));\n"
+                 "   memcpy(buf + 8, &schema, sizeof(schema));\n"
+                 "   memcpy(buf + 16, &count, sizeof(count));\n"
+    );
+    meta_buffer_printf(out, "   return META_VIEW_HEADER_SIZE;\n}\n\n");
+
+    meta_buffer_printf(
+        out,
+        "static inline int %sData_open_view(const unsigned char *buf, size_t size, %sDataView *first, uint64_t *count) {\n"
+        "   uint32_t words[2];\n"
+        "   uint64_t schema;\n"
+        "   if (size < META_VIEW_HEADER_SIZE) return -1;\n",
+        name, name
+    );
+    meta_buffer_printf(
+        out,
+        little ? "   meta_le_copy(words, buf, 2, sizeof(uint32_t));\n"
+                 "   meta_le_copy(&schema, buf + 8, 1, sizeof(schema));\n"
+                 "   meta_le_copy(count, buf + 16, 1, sizeof(*count));\n"
+               : "   memcpy(words, buf, sizeof(words));\n"
+                 "   memcpy(&schema, buf + 8, sizeof(schema));\n"
+                 "   memcpy(count, buf + 16, sizeof(*count));\n"
+    );
+    meta_buffer_printf(
+        out,
+        "   if (words[0] != META_VIEW_MAGIC || words[1] != META_VIEW_FORMAT || schema != %sData_SCHEMA) return -1;\n",
+        name
+    );
+    // Records without wire bytes fit any buffer, and a division by the constant 0 would warn
+    if (!meta_wire_size_empty(obj)) {
+        meta_buffer_printf(out, "   if (*count > (size - META_VIEW_HEADER_SIZE) / %sData_WIRE_SIZE) return -1;\n", name);
+    }
+    meta_buffer_printf(out, "   first->data = buf + META_VIEW_HEADER_SIZE;\n   return 0;\n}\n\n");
+}
+
+// Must match `meta_text_hash` in the generated code, see `meta_write_text_helpers`
+static uint32_t meta_text_seed_hash(const char *s, size_t len, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (size_t i = 0; i < len; i++) h = (h ^ (unsigned char)s[i]) * 16777619u;
+    // The low bits of FNV only depend on the low bits of the input, the table index needs all of them
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    return h ^ (h >> 13);
+}
+
+/**
+ * Finds a seed and a power of two table size for which `meta_text_seed_hash`
+ * sends every emitted member name of an object to its own slot.
+ *
+ * @return 0 on success, -1 if there is none (e.g. duplicate names) or memory ran out.
+ */
+static int meta_text_perfect_hash(const meta_object *obj, uint32_t *seed, uint32_t *mask) {
+    uint32_t count = 0, size = 1;
+    for (int i = 0; i < obj->field_count; i++) count += meta_field_emitted(&obj->fields[i]);
+    while (size < count) size *= 2;
+
+    // Small tables first, so the switch stays dense
+    for (; size <= (1u << 16); size *= 2) {
+        unsigned char *used = (unsigned char *)malloc(size);
+        if (!used) return -1;
+        for (uint32_t candidate = 0; candidate < 4096; candidate++) {
+            int i;
+            memset(used, 0, size);
+            for (i = 0; i < obj->field_count; i++) {
+                const meta_field *field = &obj->fields[i];
+                if (!meta_field_emitted(field)) continue;
+                uint32_t slot = meta_text_seed_hash(field->name, strlen(field->name), candidate) & (size - 1);
+                if (used[slot]) break;
+                used[slot] = 1;
+            }
+            if (i == obj->field_count) {
+                free(used);
+                *seed = candidate;
+                *mask = size - 1;
+                return 0;
+            }
+        }
+        free(used);
+    }
+    return -1;
+}
+
+// Writes the statements that parse one value at `p` into `target`, leaving `p` NULL on error
+static void meta_write_text_value(meta_buffer *out, const meta_field *field, const char *target, const char *indent) {
+    unsigned int flags = meta_c_name_flags(field->type, strlen(field->type));
+    if (field->object) {
+        meta_buffer_printf(out, "%sp = meta_text_name(p, end, \"%s\", 0);\n", indent, field->type);
+        meta_buffer_printf(out, "%sif (p) p = %sData_parse_text(p, end, &%s);\n", indent, field->type, target);
+    } else if (strcmp(field->type, "_Bool") == 0) {
+        meta_buffer_printf(out, "%s{ int x; p = meta_text_bool(p, end, &x); if (p) %s = x != 0; }\n", indent, target);
+    } else if (strcmp(field->type, "char") == 0) {
+        meta_buffer_printf(out, "%s{ char x; p = meta_text_char(p, end, &x); if (p) %s = x; }\n", indent, target);
+    } else if (flags & META_C_INTEGER) {
+        meta_buffer_printf(
+            out,
+            flags & META_C_UNSIGNED ? "%s{ unsigned long long x; p = meta_text_uint(p, end, &x); if (p) %s = (%s)x; }\n"
+                                    : "%s{ long long x; p = meta_text_int(p, end, &x); if (p) %s = (%s)x; }\n",
+            indent, target, field->type
+        );
+    } else if (strcmp(field->type, "float") == 0 || strcmp(field->type, "double") == 0 || strcmp(field->type, "long double") == 0) {
+        meta_buffer_printf(out, "%s{ double x; p = meta_text_float(p, end, &x); if (p) %s = (%s)x; }\n", indent, target, field->type);
+    } else {
+        meta_buffer_printf(out, "%sp = NULL;  // No text form for '%s'\n", indent, field->type);
+    }
+}
+
+// Writes the statements that parse the value of one member of `v`
+static void meta_write_text_field(meta_buffer *out, const meta_field *field) {
+    char target[160];
+    if (field->count && strcmp(field->type, "char") == 0) {
+        meta_buffer_printf(out, "         p = meta_text_string(p, end, v->%s, sizeof(v->%s));\n", field->name, field->name);
+    } else if (field->count) {
+        snprintf(target, sizeof(target), "v->%s[i]", field->name);
+        meta_buffer_printf(out, "         p = meta_text_expect(p, end, '[');\n");
+        meta_buffer_printf(out, "         for (size_t i = 0; p && (p = meta_text_skip(p, end)) < end && *p != ']'; i++) {\n");
+        meta_buffer_printf(out, "            if (i == %d) return NULL;\n", field->count);
+        meta_write_text_value(out, field, target, "            ");
+        meta_buffer_printf(out, "         }\n         if (p) p = meta_text_expect(p, end, ']');\n");
+    } else {
+        snprintf(target, sizeof(target), "v->%s", field->name);
+        meta_write_text_value(out, field, target, "         ");
+    }
+}
+
+/**
+ * Writes a loader for instance data written as text, e.g.
+ * "Player { health = 100 name = \"Bob\" pos = { x = 1 y = 2 } }". Member
+ * names are dispatched with a `switch` over a perfect hash found at
+ * generation time, and numbers are read without `sscanf` or the locale.
+ * Arrays are written in brackets, `[1 2 3]`, and `char` arrays as strings.
+ * Members left out are zero, unknown members are an error.
+ *
+ * Example output:
+ *     static inline const char *ObjectNameData_parse_text(const char *p, const char *end, ObjectNameData *v);
+ *     static inline size_t ObjectNameData_load_text(const char *text, size_t len, ObjectNameData *out,
+ *                                                   size_t capacity, const char **error);
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid object with META_OPT_TEXT set.
+ */
+static void meta_write_text_loader(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    uint32_t seed = 0, mask = 0;
+    int perfect = meta_text_perfect_hash(obj, &seed, &mask) == 0;
+    int members = 0;
+    for (int i = 0; i < obj->field_count; i++) members += meta_field_emitted(&obj->fields[i]);
+
+    meta_buffer_printf(
+        out,
+        "static inline const char *%sData_parse_text(const char *p, const char *end, %sData *v) {\n"
+        "   const char *word;\n"
+        "   size_t len;\n"
+        "   p = meta_text_expect(p, end, '{');\n"
+        "   while (p) {\n"
+        "      p = meta_text_skip(p, end);\n"
+        "      if (p < end && *p == '}') return p + 1;\n"
+        "      p = meta_text_word(p, end, &word, &len);\n"
+        "      if (p) p = meta_text_expect(p, end, '=');\n"
+        "      if (!p) return NULL;\n",
+        name, name
+    );
+    if (!members) meta_buffer_printf(out, "      (void)v;\n");
+    // Without a perfect hash (duplicate names, or out of memory) every member is tried in turn
+    if (perfect) meta_buffer_printf(out, "      switch (meta_text_hash(word, len, %uu) & %uu) {\n", seed, mask);
+    for (int i = 0, tried = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        unsigned long len = (unsigned long)strlen(field->name);
+        if (perfect) {
+            meta_buffer_printf(out, "      case %u:\n", meta_text_seed_hash(field->name, len, seed) & mask);
+            meta_buffer_printf(out, "         if (len != %lu || memcmp(word, \"%s\", %lu) != 0) return NULL;\n", len, field->name, len);
+        } else {
+            meta_buffer_printf(out, "      %sif (len == %lu && memcmp(word, \"%s\", %lu) == 0) {\n", tried++ ? "} else " : "", len, field->name, len);
+        }
+        meta_write_text_field(out, field);
+        if (perfect) meta_buffer_printf(out, "         break;\n");
+    }
+    if (perfect) meta_buffer_printf(out, "      default:\n         return NULL;\n      }\n");
+    else if (members) meta_buffer_printf(out, "      } else {\n         return NULL;\n      }\n");
+    else meta_buffer_printf(out, "      return NULL;\n");
+    meta_buffer_printf(out, "   }\n   return NULL;\n}\n\n");
+
+    meta_buffer_printf(
+        out,
+        "static inline size_t %sData_load_text(const char *text, size_t len, %sData *out, size_t capacity, const char **error) {\n"
+        "   const char *p = text, *end = text + len;\n"
+        "   size_t count = 0;\n"
+        "   *error = NULL;\n"
+        "   while ((p = meta_text_skip(p, end)) < end) {\n"
+        "      const char *start = p;\n"
+        "      if (count == capacity) {\n"
+        "         *error = start;\n"
+        "         break;\n"
+        "      }\n"
+        "      memset(&out[count], 0, sizeof(%sData));\n"
+        "      p = meta_text_name(p, end, \"%s\", 1);\n"
+        "      if (p) p = %sData_parse_text(p, end, &out[count]);\n"
+        "      if (!p) {\n"
+        "         *error = start;\n"
+        "         break;\n"
+        "      }\n"
+        "      count++;\n"
+        "   }\n"
+        "   return count;\n"
+        "}\n\n",
+        name, name, name, name, name
+    );
+}
+
+/**
+ * Writes dirty tracking and delta encoding for replicating an object. Every
+ * emitted member owns one bit of an `XDataDirty` mask, which the generated
+ * setters mark. A delta is the mask followed by the marked members in the
+ * wire format of `XData_write`, so unchanged members cost one bit each.
+ *
+ * Example output:
+ *     #define ObjectNameData_DIRTY_BYTES 1
+ *     #define ObjectNameData_DELTA_MAX_SIZE (ObjectNameData_DIRTY_BYTES + ObjectNameData_WIRE_SIZE)
+ *     typedef struct ObjectNameDataDirty {
+ *        unsigned char bits[ObjectNameData_DIRTY_BYTES];
+ *     } ObjectNameDataDirty;
+ *
+ * followed by `_set_<field>` per member, `_write_dirty`, which writes the
+ * members marked in a mask, `_write_delta`, which writes the members that
+ * differ from a previous value, and `_apply_delta`.
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid object with META_OPT_DELTA and META_OPT_SERIALIZE set.
+ */
+static void meta_write_delta(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    int members = 0;
+    for (int i = 0; i < obj->field_count; i++) members += meta_field_emitted(&obj->fields[i]);
+    int bytes = members ? (members + 7) / 8 : 1;
+
+    meta_buffer_printf(out, "#define %sData_DIRTY_BYTES %d\n", name, bytes);
+    meta_buffer_printf(out, "#define %sData_DELTA_MAX_SIZE (%sData_DIRTY_BYTES + %sData_WIRE_SIZE)\n\n", name, name, name);
+    meta_buffer_printf(out, "typedef struct %sDataDirty {\n   unsigned char bits[%sData_DIRTY_BYTES];\n} %sDataDirty;\n\n", name, name, name);
+
+    for (int i = 0, bit = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        const char *suffix = field->object ? "Data" : "";
+        meta_buffer_printf(out, "static inline void %sData_set_%s(%sData *v, %sDataDirty *dirty, ", name, field->name, name, name);
+        if (field->count) {
+            meta_buffer_printf(out, "const %s%s value[%d]) {\n", field->type, suffix, field->count);
+            meta_buffer_printf(out, "   memcpy(v->%s, value, sizeof(v->%s));\n", field->name, field->name);
+        } else {
+            meta_buffer_printf(out, "%s%s value) {\n   v->%s = value;\n", field->type, suffix, field->name);
+        }
+        meta_buffer_printf(out, "   dirty->bits[%d] |= 0x%02x;\n}\n\n", bit / 8, 1u << (bit % 8));
+        bit++;
+    }
+
+    meta_buffer_printf(out, "static inline size_t %sData_write_dirty(unsigned char *buf, const %sData *v, const %sDataDirty *dirty) {\n", name, name, name);
+    meta_buffer_printf(out, "   size_t n = %sData_DIRTY_BYTES;\n   memcpy(buf, dirty->bits, n);\n", name);
+    if (!members) meta_buffer_printf(out, "   (void)v;\n");
+    for (int i = 0, bit = 0; i < obj->field_count; i++) {
+        if (!meta_field_emitted(&obj->fields[i])) continue;
+        meta_buffer_printf(out, "   if (dirty->bits[%d] & 0x%02x) {\n", bit / 8, 1u << (bit % 8));
+        meta_write_field_io(out, &obj->fields[i], 0, (obj->options & META_OPT_LITTLE_ENDIAN) != 0, "      ");
+        meta_buffer_printf(out, "   }\n");
+        bit++;
+    }
+    meta_buffer_printf(out, "   return n;\n}\n\n");
+
+    meta_buffer_printf(out, "static inline size_t %sData_write_delta(unsigned char *buf, const %sData *prev, const %sData *v) {\n", name, name, name);
+    meta_buffer_printf(out, "   %sDataDirty dirty = {{0}};\n", name);
+    if (!members) meta_buffer_printf(out, "   (void)prev;\n");
+    for (int i = 0, bit = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        // Padding inside a nested struct can only make a member look changed, never hide a change
+        if (field->bits) meta_buffer_printf(out, "   if (prev->%s != v->%s)", field->name, field->name);
+        else meta_buffer_printf(out, "   if (memcmp(&prev->%s, &v->%s, sizeof(v->%s)) != 0)", field->name, field->name, field->name);
+        meta_buffer_printf(out, " dirty.bits[%d] |= 0x%02x;\n", bit / 8, 1u << (bit % 8));
+        bit++;
+    }
+    meta_buffer_printf(out, "   return %sData_write_dirty(buf, v, &dirty);\n}\n\n", name);
+
+    meta_buffer_printf(out, "static inline size_t %sData_apply_delta(const unsigned char *buf, %sData *v) {\n", name, name);
+    meta_buffer_printf(out, "   size_t n = %sData_DIRTY_BYTES;\n", name);
+    if (!members) meta_buffer_printf(out, "   (void)buf;\n   (void)v;\n");
+    for (int i = 0, bit = 0; i < obj->field_count; i++) {
+        if (!meta_field_emitted(&obj->fields[i])) continue;
+        meta_buffer_printf(out, "   if (buf[%d] & 0x%02x) {\n", bit / 8, 1u << (bit % 8));
+        meta_write_field_io(out, &obj->fields[i], 1, (obj->options & META_OPT_LITTLE_ENDIAN) != 0, "      ");
+        meta_buffer_printf(out, "   }\n");
+        bit++;
+    }
+    meta_buffer_printf(out, "   return n;\n}\n\n");
+}
+
+// Nested members of an object from an earlier parse are compared as raw bytes
+static int meta_field_hashable(const meta_field *field) {
+    return field->object && (field->object->options & META_OPT_HASH);
+}
+
+/**
+ * Writes `XData_eq` and `XData_hash`, which look at the bytes of every
+ * emitted member but not at the padding between them, and recurse into
+ * nested objects. When the struct has no padding (its size equals
+ * `XData_PACKED_SIZE`) both work on the whole struct as one block. Members
+ * are compared bit for bit, so e.g. `0.0f` and `-0.0f` differ. A `long
+ * double` only counts with its META_LDBL_BYTES value bytes, the padding
+ * inside x87 extended precision values is skipped too.
+ *
+ * Example output:
+ *     #define ObjectNameData_PACKED_SIZE (sizeof(int) + OtherData_PACKED_SIZE)
+ *     static inline int ObjectNameData_eq(const ObjectNameData *a, const ObjectNameData *b);
+ *     static inline uint64_t ObjectNameData_hash(const ObjectNameData *v, uint64_t seed);
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid object with META_OPT_HASH set.
+ */
+static void meta_write_hash(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    int members = 0;
+
+    meta_buffer_printf(out, "#define %sData_PACKED_SIZE (", name);
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        if (members++) meta_buffer_printf(out, " + ");
+        if (field->count) meta_buffer_printf(out, "%d * ", field->count);
+        if (meta_field_hashable(field)) meta_buffer_printf(out, "%sData_PACKED_SIZE", field->type);
+        else if (meta_field_long_double(field)) meta_buffer_printf(out, "META_LDBL_BYTES");
+        else meta_buffer_printf(out, "sizeof(%s%s)", field->type, field->object ? "Data" : "");
+    }
+    meta_buffer_printf(out, "%s)\n\n", members ? "" : "0");
+
+    meta_buffer_printf(out, "static inline int %sData_eq(const %sData *a, const %sData *b) {\n", name, name, name);
+    if (!obj->bitfields) {
+        meta_buffer_printf(out, "   if (sizeof(%sData) == %sData_PACKED_SIZE) return memcmp(a, b, sizeof(%sData)) == 0;\n", name, name, name);
+    }
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        if (meta_field_hashable(field) && field->count) {
+            meta_buffer_printf(out, "   for (size_t i = 0; i < %d; i++) {\n", field->count);
+            meta_buffer_printf(out, "      if (!%sData_eq(&a->%s[i], &b->%s[i])) return 0;\n   }\n", field->type, field->name, field->name);
+        } else if (meta_field_hashable(field)) {
+            meta_buffer_printf(out, "   if (!%sData_eq(&a->%s, &b->%s)) return 0;\n", field->type, field->name, field->name);
+        } else if (field->bits) {
+            meta_buffer_printf(out, "   if (a->%s != b->%s) return 0;\n", field->name, field->name);
+        } else if (meta_field_long_double(field) && field->count) {
+            meta_buffer_printf(out, "   for (size_t i = 0; i < %d; i++) {\n", field->count);
+            meta_buffer_printf(out, "      if (memcmp(&a->%s[i], &b->%s[i], META_LDBL_BYTES) != 0) return 0;\n   }\n", field->name, field->name);
+        } else if (meta_field_long_double(field)) {
+            meta_buffer_printf(out, "   if (memcmp(&a->%s, &b->%s, META_LDBL_BYTES) != 0) return 0;\n", field->name, field->name);
+        } else {
+            meta_buffer_printf(out, "   if (memcmp(&a->%s, &b->%s, sizeof(a->%s)) != 0) return 0;\n", field->name, field->name, field->name);
+        }
+    }
+    meta_buffer_printf(out, "   return 1;\n}\n\n");
+
+    meta_buffer_printf(out, "static inline uint64_t %sData_hash(const %sData *v, uint64_t seed) {\n", name, name);
+    if (!obj->bitfields) {
+        meta_buffer_printf(out, "   if (sizeof(%sData) == %sData_PACKED_SIZE) return meta_hash_block(v, sizeof(%sData), seed);\n", name, name, name);
+    }
+    meta_buffer_printf(out, "   uint64_t h = seed;\n");
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        if (meta_field_hashable(field) && field->count) {
+            meta_buffer_printf(out, "   for (size_t i = 0; i < %d; i++) h = %sData_hash(&v->%s[i], h);\n", field->count, field->type, field->name);
+        } else if (meta_field_hashable(field)) {
+            meta_buffer_printf(out, "   h = %sData_hash(&v->%s, h);\n", field->type, field->name);
+        } else if (field->bits) {
+            meta_buffer_printf(out, "   { %s t = v->%s; h = meta_hash_block(&t, sizeof(t), h); }\n", field->type, field->name);
+        } else if (meta_field_long_double(field) && field->count) {
+            meta_buffer_printf(out, "   for (size_t i = 0; i < %d; i++) h = meta_hash_block(&v->%s[i], META_LDBL_BYTES, h);\n", field->count, field->name);
+        } else if (meta_field_long_double(field)) {
+            meta_buffer_printf(out, "   h = meta_hash_block(&v->%s, META_LDBL_BYTES, h);\n", field->name);
+        } else {
+            meta_buffer_printf(out, "   h = meta_hash_block(&v->%s, sizeof(v->%s), h);\n", field->name, field->name);
+        }
+    }
+    meta_buffer_printf(out, "   return h;\n}\n\n");
+}
+
+/**
+ * Writes `XDataPool`, a fixed-capacity pool for an object with `@pool(N)`,
+ * and the functions to use it. Live objects are kept densely packed at the
+ * front of `items`, which is aligned to a cache line, so iterating over them
+ * is a plain loop over `items[0 .. count)`. They are reached through
+ * generational handles that stay valid while objects move, and go stale
+ * once their object is freed. A zero-initialized pool is empty and ready.
+ *
+ * Example output:
+ *     #define ObjectNameData_POOL_CAPACITY 256
+ *     typedef struct ObjectNameDataHandle {
+ *        uint32_t index;
+ *        uint32_t generation;
+ *     } ObjectNameDataHandle;
+ *     typedef struct ObjectNameDataPool {
+ *        META_ALIGNAS(64) ObjectNameData items[ObjectNameData_POOL_CAPACITY];
+ *        ...
+ *     } ObjectNameDataPool;
+ *
+ * followed by `_alloc`, `_free`, `_get` and `_handle_at`.
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid object with a `pool_capacity`.
+ */
+static void meta_write_pool(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    // An alignment may only raise that of the type, never lower it
+    size_t align = obj->align > 64 ? obj->align : 64;
+
+    meta_buffer_printf(out, "#define %sData_POOL_CAPACITY %u\n\n", name, obj->pool_capacity);
+    meta_buffer_printf(out, "typedef struct %sDataHandle {\n   uint32_t index;\n   uint32_t generation;\n} %sDataHandle;\n\n", name, name);
+    meta_buffer_printf(
+        out,
+        "typedef struct %sDataPool {\n"
+        "   META_ALIGNAS(%lu) %sData items[%sData_POOL_CAPACITY];  // Live objects in [0, count)\n"
+        "   uint32_t slots[%sData_POOL_CAPACITY];        // Slot of each item\n"
+        "   uint32_t dense[%sData_POOL_CAPACITY];        // Item of each slot\n"
+        "   uint32_t generations[%sData_POOL_CAPACITY];  // Of each slot, odd while it is live\n"
+        "   uint32_t next_free[%sData_POOL_CAPACITY];    // 1 + next free slot, 0 ends the list\n"
+        "   uint32_t free_head;  // 1 + first free slot, 0 if there is none\n"
+        "   uint32_t used;       // Slots handed out at least once\n"
+        "   uint32_t count;\n"
+        "} %sDataPool;\n\n",
+        name, (unsigned long)align, name, name, name, name, name, name, name
+    );
+
+    meta_buffer_printf(
+        out,
+        "static inline %sData *%sData_alloc(%sDataPool *pool, %sDataHandle *handle) {\n"
+        "   uint32_t slot;\n"
+        "   if (pool->free_head) {\n"
+        "      slot = pool->free_head - 1;\n"
+        "      pool->free_head = pool->next_free[slot];\n"
+        "   } else if (pool->used < %sData_POOL_CAPACITY) {\n"
+        "      slot = pool->used++;\n"
+        "   } else {\n"
+        "      return NULL;\n"
+        "   }\n"
+        "   uint32_t item = pool->count++;\n"
+        "   pool->generations[slot]++;\n"
+        "   pool->dense[slot] = item;\n"
+        "   pool->slots[item] = slot;\n"
+        "   handle->index = slot;\n"
+        "   handle->generation = pool->generations[slot];\n"
+        "   memset(&pool->items[item], 0, sizeof(%sData));\n"
+        "   return &pool->items[item];\n"
+        "}\n\n",
+        name, name, name, name, name, name
+    );
+    meta_buffer_printf(
+        out,
+        "static inline %sData *%sData_get(%sDataPool *pool, %sDataHandle handle) {\n"
+        "   if (handle.index >= %sData_POOL_CAPACITY || !(handle.generation & 1u) ||\n"
+        "       pool->generations[handle.index] != handle.generation) return NULL;\n"
+        "   return &pool->items[pool->dense[handle.index]];\n"
+        "}\n\n",
+        name, name, name, name, name
+    );
+    meta_buffer_printf(
+        out,
+        "static inline void %sData_free(%sDataPool *pool, %sDataHandle handle) {\n"
+        "   if (!%sData_get(pool, handle)) return;\n"
+        "   uint32_t slot = handle.index, item = pool->dense[slot], last = --pool->count;\n"
+        "   // The last item fills the hole, so the live items stay packed\n"
+        "   pool->items[item] = pool->items[last];\n"
+        "   pool->slots[item] = pool->slots[last];\n"
+        "   pool->dense[pool->slots[item]] = item;\n"
+        "   pool->generations[slot]++;\n"
+        "   pool->next_free[slot] = pool->free_head;\n"
+        "   pool->free_head = slot + 1;\n"
+        "}\n\n",
+        name, name, name, name
+    );
+    meta_buffer_printf(
+        out,
+        "static inline %sDataHandle %sData_handle_at(const %sDataPool *pool, uint32_t item) {\n"
+        "   %sDataHandle handle;\n"
+        "   handle.index = pool->slots[item];\n"
+        "   handle.generation = pool->generations[handle.index];\n"
+        "   return handle;\n"
+        "}\n\n",
+        name, name, name, name
+    );
+}
+
+// Host offsets of the emitted members, as laid out by `meta_layout_object`
+static void meta_field_offsets(const meta_object *obj, size_t *offsets) {
+    size_t offset = 0;
+    int members = 0;
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        size_t size, align;
+        offsets[i] = 0;
+        if (!meta_field_emitted(field)) continue;
+        meta_field_layout(field, &size, &align);
+        if (!field->bits && !members++ && obj->align_request > align) align = obj->align_request;
+        offset = (offset + align - 1) / align * align;
+        offsets[i] = offset;
+        offset += size;
+    }
+}
+
+// Members whose bytes mean the same in both layouts, so they can be copied as they are
+static int meta_field_same(const meta_field *a, const meta_field *b) {
+    return a->type == b->type && a->object == b->object && a->count == b->count && !a->bits && !b->bits;
+}
+
+// Index of the next emitted member after `i`, or `obj->field_count` if there is none
+static int meta_next_emitted(const meta_object *obj, int i) {
+    while (++i < obj->field_count && !meta_field_emitted(&obj->fields[i])) {}
+    return i;
+}
+
+static void meta_write_zero_field(meta_buffer *out, const meta_field *field) {
+    if (field->bits) meta_buffer_printf(out, "      dst[i].%s = 0;\n", field->name);
+    else meta_buffer_printf(out, "      memset(&dst[i].%s, 0, sizeof(dst[i].%s));\n", field->name, field->name);
+}
+
+// Converts one member that changed type or length, as if assigned element by element
+static void meta_write_migrate_field(meta_buffer *out, const meta_field *to, const meta_field *from) {
+    const char *name = to->name;
+    int cast = !to->object && to->type != from->type;
+    if ((to->count == 0) != (from->count == 0) || to->object != from->object) {
+        meta_write_zero_field(out, to);
+    } else if (!to->count) {
+        if (cast) meta_buffer_printf(out, "      dst[i].%s = (%s)src[i].%s;\n", name, to->type, name);
+        else meta_buffer_printf(out, "      dst[i].%s = src[i].%s;\n", name, name);
+    } else {
+        int count = to->count < from->count ? to->count : from->count;
+        if (cast) {
+            meta_buffer_printf(out, "      for (size_t k = 0; k < %d; k++) dst[i].%s[k] = (%s)src[i].%s[k];\n", count, name, to->type, name);
+        } else {
+            meta_buffer_printf(out, "      memcpy(dst[i].%s, src[i].%s, %d * sizeof(dst[i].%s[0]));\n", name, name, count, name);
+        }
+        if (to->count > count) {
+            meta_buffer_printf(out, "      memset(dst[i].%s + %d, 0, %d * sizeof(dst[i].%s[0]));\n", name, count, to->count - count, name);
+        }
+    }
+}
+
+// Writes the struct of an earlier layout, as `meta_write_object` wrote it back then
+static void meta_write_prior_object(meta_buffer *out, const meta_object *obj, const meta_object *prior) {
+    unsigned int object_align = prior->align_request;
+    meta_buffer_printf(out, "typedef struct %sDataV%u {\n", obj->name, prior->version);
+    for (int i = 0; i < prior->field_count; i++) {
+        const meta_field *field = &prior->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        if (field->bits) {
+            meta_buffer_printf(out, "   %s %s : %d;\n", field->type, field->name, field->bits);
+            continue;
+        }
+        unsigned int align = field->align_request > object_align ? field->align_request : object_align;
+        char dims[16] = "";
+        if (field->count) snprintf(dims, sizeof(dims), "[%d]", field->count);
+        object_align = 0;
+        meta_buffer_printf(out, "   ");
+        if (align) meta_buffer_printf(out, "META_ALIGNAS(%u) ", align);
+        meta_buffer_printf(out, "%s%s %s%s;\n", field->type, field->object ? "Data" : "", field->name, dims);
+    }
+    meta_buffer_printf(out, "} %sDataV%u;\n\n", obj->name, prior->version);
+}
+
+/**
+ * Writes `XData_VERSION` and, for every earlier layout kept in the cache, its
+ * struct and a function migrating records of that version to the current one.
+ * Members are matched by name. Runs of members that sit at the same relative
+ * offsets in both layouts are copied with one `memcpy`, and when the layouts
+ * are identical the whole array is. Members that changed type are converted
+ * as by assignment, missing ones and ones that changed between a scalar and
+ * an array or to another object start out zeroed.
+ *
+ * Example output:
+ *     #define ObjectNameData_VERSION 2
+ *
+ *     typedef struct ObjectNameDataV1 {
+ *        ...
+ *     } ObjectNameDataV1;
+ *
+ *     static inline void ObjectNameData_migrate_v1_to_v2(ObjectNameData *dst, const ObjectNameDataV1 *src, size_t count) {
+ *        for (size_t i = 0; i < count; i++) {
+ *           memcpy(&dst[i].field1, &src[i].field1, offsetof(ObjectNameData, field2) + sizeof(dst[i].field2) - offsetof(ObjectNameData, field1));
+ *           memset(&dst[i].field3, 0, sizeof(dst[i].field3));
+ *        }
+ *     }
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid, laid out object with a `version`.
+ */
+static void meta_write_migrations(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    meta_buffer_printf(out, "#define %sData_VERSION %u\n\n", name, obj->version);
+
+    for (const meta_object *prior = obj->prior; prior; prior = prior->prior) {
+        size_t n = (size_t)obj->field_count, m = (size_t)prior->field_count;
+        int *from = (int *)malloc((n ? n : 1) * sizeof(int));
+        size_t *to_offsets = (size_t *)malloc((n ? n : 1) * sizeof(size_t));
+        size_t *from_offsets = (size_t *)malloc((m ? m : 1) * sizeof(size_t));
+        if (!from || !to_offsets || !from_offsets) {
+            free(from); free(to_offsets); free(from_offsets);
+            out->failed = 1;
+            return;
+        }
+
+        // Bitfield packing is up to the compiler, so offsets are only known without them
+        int known = !obj->bitfields && !prior->bitfields;
+        if (known) {
+            meta_field_offsets(obj, to_offsets);
+            meta_field_offsets(prior, from_offsets);
+        }
+
+        // Names are interned, so members match by pointer
+        int members = 0, identical = known && obj->size == prior->size;
+        for (size_t j = 0; j < n; j++) {
+            const meta_field *field = &obj->fields[j];
+            from[j] = -1;
+            if (!meta_field_emitted(field)) continue;
+            for (size_t s = 0; s < m && from[j] < 0; s++) {
+                if (meta_field_emitted(&prior->fields[s]) && prior->fields[s].name == field->name) from[j] = (int)s;
+            }
+            identical = identical && from[j] >= 0 && meta_field_same(field, &prior->fields[from[j]]) && to_offsets[j] == from_offsets[from[j]];
+            members++;
+        }
+        for (size_t s = 0; s < m; s++) {
+            if (meta_field_emitted(&prior->fields[s])) members--;
+        }
+        identical &= members == 0;
+
+        meta_write_prior_object(out, obj, prior);
+        meta_buffer_printf(
+            out,
+            "static inline void %sData_migrate_v%u_to_v%u(%sData *dst, const %sDataV%u *src, size_t count) {\n",
+            name, prior->version, obj->version, name, name, prior->version
+        );
+
+        int first = meta_next_emitted(obj, -1);
+        if (first == obj->field_count) {
+            meta_buffer_printf(out, "   (void)dst;\n   (void)src;\n   (void)count;\n");
+        } else if (identical) {
+            meta_buffer_printf(out, "   memcpy(dst, src, count * sizeof(*dst));\n");
+        } else {
+            meta_buffer_printf(out, "   for (size_t i = 0; i < count; i++) {\n");
+            for (int j = first; j < obj->field_count; j = meta_next_emitted(obj, j)) {
+                const meta_field *field = &obj->fields[j];
+                int s = from[j];
+                if (s < 0) {
+                    meta_write_zero_field(out, field);
+                    continue;
+                }
+                if (!meta_field_same(field, &prior->fields[s])) {
+                    meta_write_migrate_field(out, field, &prior->fields[s]);
+                    continue;
+                }
+
+                // Grow the run while the next members follow each other in both layouts at the same distance
+                int last = j;
+                for (;;) {
+                    int next = meta_next_emitted(obj, last);
+                    if (!known || next == obj->field_count || from[next] != meta_next_emitted(prior, from[last])) break;
+                    if (!meta_field_same(&obj->fields[next], &prior->fields[from[next]])) break;
+                    if (to_offsets[next] - to_offsets[j] != from_offsets[from[next]] - from_offsets[s]) break;
+                    last = next;
+                }
+                if (last == j && !field->count) {
+                    meta_buffer_printf(out, "      dst[i].%s = src[i].%s;\n", field->name, field->name);
+                } else if (last == j) {
+                    meta_buffer_printf(out, "      memcpy(dst[i].%s, src[i].%s, sizeof(dst[i].%s));\n", field->name, field->name, field->name);
+                } else {
+                    const char *end = obj->fields[last].name;
+                    meta_buffer_printf(
+                        out,
+                        "      memcpy(&dst[i].%s, &src[i].%s, offsetof(%sData, %s) + sizeof(dst[i].%s) - offsetof(%sData, %s));\n",
+                        field->name, field->name, name, end, end, name, field->name
+                    );
+                }
+                j = last;
+            }
+            meta_buffer_printf(out, "   }\n");
+        }
+        meta_buffer_printf(out, "}\n\n");
+
+        free(from);
+        free(to_offsets);
+        free(from_offsets);
+    }
+}
+
+/**
+ * Writes `XDataSoA`, a structure-of-arrays container with one array per
+ * emitted member, and the functions to fill it. Loops over one member then
+ * touch a single contiguous array.
+ *
+ * Example output:
+ *     typedef struct ObjectNameDataSoA {
+ *        type *field1;
+ *        type *field2;
+ *        size_t count;
+ *        size_t capacity;
+ *     } ObjectNameDataSoA;
+ *
+ * followed by `_reserve`, `_free`, `_push`, `_swap_remove`, `_get`, `_set`,
+ * `_from_array` and `_to_array`.
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid object with META_OPT_SOA set.
+ */
+static void meta_write_soa(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    const meta_field *fields = obj->fields;
+    int count = obj->field_count, members = 0;
+    for (int i = 0; i < count; i++) members += meta_field_emitted(&fields[i]);
+    const char *unused = members ? "" : "   (void)soa; (void)index; (void)v;\n";
+
+    // An array member becomes an array of arrays, e.g. `float (*samples)[64]`
+    meta_buffer_printf(out, "typedef struct %sDataSoA {\n", name);
+    for (int i = 0; i < count; i++) {
+        const meta_field *field = &fields[i];
+        if (!meta_field_emitted(field)) continue;
+        if (field->count) meta_buffer_printf(out, "   %s%s (*%s)[%d];\n", field->type, field->object ? "Data" : "", field->name, field->count);
+        else meta_buffer_printf(out, "   %s%s *%s;\n", field->type, field->object ? "Data" : "", field->name);
+    }
+    meta_buffer_printf(out, "   size_t count;\n   size_t capacity;\n} %sDataSoA;\n\n", name);
+
+    // Columns grow one by one, after a failure the container keeps its old capacity
+    meta_buffer_printf(out, "static inline int %sDataSoA_reserve(%sDataSoA *soa, size_t capacity) {\n", name, name);
+    meta_buffer_printf(out, "%s   if (capacity <= soa->capacity) return 0;\n", members ? "   void *grown;\n" : "");
+    for (int i = 0; i < count; i++) {
+        if (!meta_field_emitted(&fields[i])) continue;
+        char dims[16] = "";
+        if (fields[i].count) snprintf(dims, sizeof(dims), "[%d]", fields[i].count);
+        meta_buffer_printf(
+            out,
+            "   grown = realloc(soa->%s, capacity * sizeof(*soa->%s));\n"
+            "   if (!grown) return -1;\n"
+            "   soa->%s = (%s%s (*)%s)grown;\n",
+            fields[i].name, fields[i].name, fields[i].name, fields[i].type, fields[i].object ? "Data" : "", dims
+        );
+    }
+    meta_buffer_printf(out, "   soa->capacity = capacity;\n   return 0;\n}\n\n");
+
+    meta_buffer_printf(out, "static inline void %sDataSoA_free(%sDataSoA *soa) {\n", name, name);
+    for (int i = 0; i < count; i++) {
+        if (meta_field_emitted(&fields[i])) meta_buffer_printf(out, "   free(soa->%s);\n", fields[i].name);
+    }
+    meta_buffer_printf(out, "   memset(soa, 0, sizeof(*soa));\n}\n\n");
+
+    meta_buffer_printf(out, "static inline void %sDataSoA_get(const %sDataSoA *soa, size_t index, %sData *v) {\n", name, name, name);
+    for (int i = 0; i < count; i++) {
+        if (!meta_field_emitted(&fields[i])) continue;
+        if (fields[i].count) meta_buffer_printf(out, "   memcpy(v->%s, soa->%s[index], sizeof(v->%s));\n", fields[i].name, fields[i].name, fields[i].name);
+        else meta_buffer_printf(out, "   v->%s = soa->%s[index];\n", fields[i].name, fields[i].name);
+    }
+    meta_buffer_printf(out, "%s}\n\n", unused);
+
+    meta_buffer_printf(out, "static inline void %sDataSoA_set(%sDataSoA *soa, size_t index, const %sData *v) {\n", name, name, name);
+    for (int i = 0; i < count; i++) {
+        if (!meta_field_emitted(&fields[i])) continue;
+        if (fields[i].count) meta_buffer_printf(out, "   memcpy(soa->%s[index], v->%s, sizeof(v->%s));\n", fields[i].name, fields[i].name, fields[i].name);
+        else meta_buffer_printf(out, "   soa->%s[index] = v->%s;\n", fields[i].name, fields[i].name);
+    }
+    meta_buffer_printf(out, "%s}\n\n", unused);
+
+    meta_buffer_printf(
+        out,
+        "static inline int %sDataSoA_push(%sDataSoA *soa, const %sData *v) {\n"
+        "   if (soa->count == soa->capacity && %sDataSoA_reserve(soa, soa->capacity ? soa->capacity * 2 : 16) != 0) return -1;\n"
+        "   %sDataSoA_set(soa, soa->count++, v);\n"
+        "   return 0;\n"
+        "}\n\n",
+        name, name, name, name, name
+    );
+
+    meta_buffer_printf(out, "static inline void %sDataSoA_swap_remove(%sDataSoA *soa, size_t index) {\n", name, name);
+    meta_buffer_printf(out, members ? "   size_t last = --soa->count;\n" : "   --soa->count;\n   (void)index;\n");
+    for (int i = 0; i < count; i++) {
+        if (!meta_field_emitted(&fields[i])) continue;
+        if (fields[i].count) meta_buffer_printf(out, "   memcpy(soa->%s[index], soa->%s[last], sizeof(*soa->%s));\n", fields[i].name, fields[i].name, fields[i].name);
+        else meta_buffer_printf(out, "   soa->%s[index] = soa->%s[last];\n", fields[i].name, fields[i].name);
+    }
+    meta_buffer_printf(out, "}\n\n");
+
+    meta_buffer_printf(
+        out,
+        "static inline int %sDataSoA_from_array(%sDataSoA *soa, const %sData *v, size_t count) {\n"
+        "   if (%sDataSoA_reserve(soa, soa->count + count) != 0) return -1;\n"
+        "   for (size_t i = 0; i < count; i++) %sDataSoA_set(soa, soa->count + i, &v[i]);\n"
+        "   soa->count += count;\n"
+        "   return 0;\n"
+        "}\n\n",
+        name, name, name, name, name
+    );
+    meta_buffer_printf(
+        out,
+        "static inline void %sDataSoA_to_array(const %sDataSoA *soa, %sData *v) {\n"
+        "   for (size_t i = 0; i < soa->count; i++) %sDataSoA_get(soa, i, &v[i]);\n"
+        "}\n\n",
+        name, name, name, name
+    );
+}
+
+// The `meta_type_id` of an emitted member
+static const char *meta_field_type_id(const meta_field *field) {
+    unsigned int flags = meta_c_name_flags(field->type, strlen(field->type));
+    if (field->object) return "META_TYPE_OBJECT";
+    if (strcmp(field->type, "_Bool") == 0) return "META_TYPE_BOOL";
+    if (strcmp(field->type, "char") == 0) return "META_TYPE_CHAR";
+    if (flags & META_C_INTEGER) return flags & META_C_UNSIGNED ? "META_TYPE_UINT" : "META_TYPE_INT";
+    if (strcmp(field->type, "float") == 0 || strcmp(field->type, "double") == 0 || strcmp(field->type, "long double") == 0) {
+        return "META_TYPE_FLOAT";
+    }
+    return "META_TYPE_OTHER";
+}
+
+/**
+ * Writes `XData_fields`, a table describing every emitted member, and for C++
+ * `meta_for_each_field`, which calls a visitor on every member with the
+ * calls unrolled at compile time. Members of a nested object point at its
+ * own table if it has one. Bitfields have no address, so they get an offset
+ * of 0 in the table and are not visited by `meta_for_each_field`.
+ *
+ * Example output:
+ *     #define ObjectNameData_FIELD_COUNT 2
+ *     static const meta_field_info ObjectNameData_fields[] = {
+ *        { "field1", "int", META_TYPE_INT, offsetof(ObjectNameData, field1), sizeof(int), 0, 0, NULL, 0 },
+ *        { "field2", "Other", META_TYPE_OBJECT, offsetof(ObjectNameData, field2), sizeof(OtherData), 0, 0, OtherData_fields, OtherData_FIELD_COUNT },
+ *     };
+ *
+ *     template <typename F>
+ *     META_CONSTEXPR void meta_for_each_field(ObjectNameData &v, F &&f) { ... }
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid object with META_OPT_REFLECT set.
+ */
+static void meta_write_reflection(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    int members = 0, visited = 0;
+    for (int i = 0; i < obj->field_count; i++) {
+        if (!meta_field_emitted(&obj->fields[i])) continue;
+        members++;
+        visited += !obj->fields[i].bits;
+    }
+
+    meta_buffer_printf(out, "#define %sData_FIELD_COUNT %d\n", name, members);
+    meta_buffer_printf(out, "static const meta_field_info %sData_fields[] = {\n", name);
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        meta_buffer_printf(out, "   { \"%s\", \"%s\", %s, ", field->name, field->type, meta_field_type_id(field));
+        if (field->bits) meta_buffer_printf(out, "0, ");
+        else meta_buffer_printf(out, "offsetof(%sData, %s), ", name, field->name);
+        meta_buffer_printf(out, "sizeof(%s%s), %d, %d, ", field->type, field->object ? "Data" : "", field->count, field->bits);
+        if (field->object && (field->object->options & META_OPT_REFLECT)) {
+            meta_buffer_printf(out, "%sData_fields, %sData_FIELD_COUNT },\n", field->type, field->type);
+        } else {
+            meta_buffer_printf(out, "NULL, 0 },\n");
+        }
+    }
+    // C has no empty arrays, an object without members gets a single zeroed entry
+    if (!members) meta_buffer_printf(out, "   { NULL, NULL, META_TYPE_OTHER, 0, 0, 0, 0, NULL, 0 },\n");
+    meta_buffer_printf(out, "};\n\n#ifdef __cplusplus\n");
+
+    for (int constant = 0; constant < 2; constant++) {
+        meta_buffer_printf(out, "template <typename F>\nMETA_CONSTEXPR void meta_for_each_field(%s%sData &v, F &&f) {\n", constant ? "const " : "", name);
+        for (int i = 0; i < obj->field_count; i++) {
+            const meta_field *field = &obj->fields[i];
+            if (!meta_field_emitted(field) || field->bits) continue;
+            meta_buffer_printf(out, "   f(\"%s\", v.%s);\n", field->name, field->name);
+        }
+        if (!visited) meta_buffer_printf(out, "   (void)v;\n   (void)f;\n");
+        meta_buffer_printf(out, constant ? "}\n" : "}\n\n");
+    }
+    meta_buffer_printf(out, "#endif\n\n");
+}
+
+/**
+ * Writes the C++ `meta::schema` specialization of an object: constexpr
+ * descriptors of its members with name, member pointer and offset, and
+ * templated `members`, `visit` and `serialize` that call their visitor or
+ * archive once per member, with nothing left to dispatch at run time.
+ * Members that are objects are serialized through their own schema, element
+ * by element for arrays. Bitfields have no address, so they get no
+ * descriptor and are not visited; `serialize` hands the archive a copy and
+ * stores it back.
+ *
+ * Example output:
+ *     namespace meta {
+ *     template <> struct schema<ObjectNameData> {
+ *        static constexpr const char *name() { return "ObjectName"; }
+ *        static constexpr size_t field_count = 1;
+ *        static constexpr meta::field<ObjectNameData, int> member(meta::index<0>) { ... }
+ *        template <typename F> static META_CONSTEXPR void members(F &&f) { ... }
+ *        template <typename V, typename F> static META_CONSTEXPR void visit(V &v, F &&f) { ... }
+ *        template <typename Archive> static void serialize(Archive &ar, ObjectNameData &v) { ... }
+ *     };
+ *     }
+ *
+ * @param out Buffer the generated code is appended to.
+ * @param obj A valid object with META_OPT_CPP set.
+ */
+static void meta_write_schema(meta_buffer *out, const meta_object *obj) {
+    const char *name = obj->name;
+    int described = 0, members = 0;
+    for (int i = 0; i < obj->field_count; i++) {
+        if (!meta_field_emitted(&obj->fields[i])) continue;
+        members++;
+        described += !obj->fields[i].bits;
+    }
+
+    meta_buffer_printf(out, "#ifdef __cplusplus\nnamespace meta {\ntemplate <> struct schema<%sData> {\n", name);
+    meta_buffer_printf(out, "   static constexpr const char *name() { return \"%s\"; }\n", name);
+    meta_buffer_printf(out, "   static constexpr size_t field_count = %d;  // Members with a descriptor\n\n", described);
+
+    int index = 0;
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        const char *suffix = field->object ? "Data" : "";
+        char dims[16] = "";
+        if (!meta_field_emitted(field) || field->bits) continue;
+        if (field->count) snprintf(dims, sizeof(dims), "[%d]", field->count);
+        meta_buffer_printf(
+            out,
+            "   static constexpr meta::field<%sData, %s%s%s> member(meta::index<%d>) {\n"
+            "      return meta::field<%sData, %s%s%s>{ \"%s\", &%sData::%s, offsetof(%sData, %s) };\n"
+            "   }\n",
+            name, field->type, suffix, dims, index, name, field->type, suffix, dims,
+            field->name, name, field->name, name, field->name
+        );
+        index++;
+    }
+    if (described) meta_buffer_printf(out, "\n");
+
+    meta_buffer_printf(out, "   template <typename F>\n   static META_CONSTEXPR void members(F &&f) {\n");
+    for (int i = 0; i < described; i++) meta_buffer_printf(out, "      f(member(meta::index<%d>()));\n", i);
+    if (!described) meta_buffer_printf(out, "      (void)f;\n");
+    meta_buffer_printf(out, "   }\n\n");
+
+    // `V` is the struct or its const version
+    meta_buffer_printf(out, "   template <typename V, typename F>\n   static META_CONSTEXPR void visit(V &v, F &&f) {\n");
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field) || field->bits) continue;
+        meta_buffer_printf(out, "      f(\"%s\", v.%s);\n", field->name, field->name);
+    }
+    if (!described) meta_buffer_printf(out, "      (void)v;\n      (void)f;\n");
+    meta_buffer_printf(out, "   }\n\n");
+
+    meta_buffer_printf(out, "   template <typename Archive>\n   static void serialize(Archive &ar, %sData &v) {\n", name);
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        if (!meta_field_emitted(field)) continue;
+        if (field->bits) {
+            meta_buffer_printf(out, "      { %s bits = v.%s; ar(\"%s\", bits); v.%s = bits; }\n", field->type, field->name, field->name, field->name);
+        } else if (field->object && field->count) {
+            meta_buffer_printf(out, "      for (size_t i = 0; i < %d; i++) meta::serialize(ar, v.%s[i]);\n", field->count, field->name);
+        } else if (field->object) {
+            meta_buffer_printf(out, "      meta::serialize(ar, v.%s);\n", field->name);
+        } else {
+            meta_buffer_printf(out, "      ar(\"%s\", v.%s);\n", field->name, field->name);
+        }
+    }
+    if (!members) meta_buffer_printf(out, "      (void)ar;\n      (void)v;\n");
+    meta_buffer_printf(out, "   }\n};\n}\n#endif\n\n");
+}
+
+/**
+ * Writes a struct for every object starting at `first`, in dependency order,
+ * each followed by the functions its options ask for.
+ *
+ * @param out   Buffer the generated code is appended to.
+ * @param sink  If not NULL, `out` is flushed to it whenever it holds
+ *              META_PARSER_SINK_CHUNK bytes or more.
+ * @param first First object to write; later objects follow through `next`.
+ * @return 0 on success, -1 if the sink failed or memory ran out.
+ */
+static int meta_write_objects(meta_buffer *out, const meta_sink *sink, meta_object *first) {
+    size_t count;
+    meta_object **order = meta_sort_objects(first, &count);
+    if (first && !order) return -1;
+
+    meta_write_prelude(out, order, count);
+    for (size_t i = 0; i < count; i++) {
+        meta_object *obj = order[i];
+        meta_write_object(out, obj);
+        if (obj->valid && (obj->options & (META_OPT_REORDER | META_OPT_ASSERT_LAYOUT))) meta_write_layout_asserts(out, obj);
+        if (obj->valid && (obj->options & META_OPT_SERIALIZE)) meta_write_serializers(out, obj);
+        if (obj->valid && (obj->options & META_OPT_DELTA)) meta_write_delta(out, obj);
+        if (obj->valid && (obj->options & META_OPT_HASH)) meta_write_hash(out, obj);
+        if (obj->valid && obj->pool_capacity) meta_write_pool(out, obj);
+        if (obj->valid && obj->version) meta_write_migrations(out, obj);
+        if (obj->valid && (obj->options & META_OPT_VIEW)) meta_write_view(out, obj);
+        if (obj->valid && (obj->options & META_OPT_TEXT)) meta_write_text_loader(out, obj);
+        if (obj->valid && (obj->options & META_OPT_SOA)) meta_write_soa(out, obj);
+        if (obj->valid && (obj->options & META_OPT_REFLECT)) meta_write_reflection(out, obj);
+        if (obj->valid && (obj->options & META_OPT_CPP)) meta_write_schema(out, obj);
+
+        if (sink && out->length >= META_PARSER_SINK_CHUNK && meta_buffer_flush(out, sink) != 0) {
+            free(order);
+            return -1;
+        }
+    }
+    free(order);
+    return 0;
+}
+
+/* -------------------------------- CACHE -------------------------------- */
+
+/*
+ * A `.metac` file holds the parse result of one input so that an unchanged
+ * input can skip lexing and parsing entirely. Everything is stored in host
+ * byte order and is read in place from the mapped file:
+ *
+ *     meta_cache_header
+ *     meta_cache_object objects[object_count + prior_count]   earlier layouts last
+ *     meta_cache_field  fields[field_count]
+ *     char              strings[string_bytes]   NUL-terminated names
+ *
+ * Earlier layouts of `@version` objects outlive changes to the input: when
+ * the input is parsed again, they are carried over from the old cache file.
+ *
+ * Bump META_CACHE_VERSION whenever this layout or the meaning of a parse
+ * result changes, so caches from older generators are ignored.
+ */
+#define META_CACHE_MAGIC   0x4341544Du  // "MTAC" in little-endian
+#define META_CACHE_VERSION 12u
+
+#define META_CACHE_NAME_VALID 0x1u
+#define META_CACHE_TYPE_VALID 0x2u
+#define META_CACHE_HOT        0x4u
+#define META_CACHE_COLD       0x8u
+
+typedef struct meta_cache_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t content_hash;  // meta_hash64 of the input bytes
+    uint64_t payload_hash;  // meta_hash64 of everything after the header
+    uint32_t object_count;
+    uint32_t field_count;
+    uint32_t string_bytes;
+    uint32_t prior_count;   // Earlier layouts, stored after the objects
+    uint32_t diagnostic_count;  // Parse warnings and errors, stored after the fields
+} meta_cache_header;
+
+typedef struct meta_cache_object {
+    uint32_t name;  // Offset into the string block
+    uint32_t first_field;
+    uint32_t field_count;
+    uint32_t options;  // META_OPT_* flags set by attributes
+    uint32_t align;    // `@align` of the object
+    uint32_t pool;     // `@pool` capacity of the object
+    uint32_t version;  // `@version` of the object or layout
+    uint32_t owner;    // Object an earlier layout belongs to; for objects, 1 + the one a `@cold` companion belongs to, or 0
+    uint32_t cacheline;  // `@cacheline` line size of the object
+    uint32_t line;     // Position in the input, for diagnostics
+    uint32_t column;
+} meta_cache_object;
+
+typedef struct meta_cache_field {
+    uint32_t name;
+    uint32_t type;
+    uint32_t flags;  // META_CACHE_*
+    uint32_t count;
+    uint32_t align;
+    int32_t bits;    // Bitfield width, -1 if invalid
+    uint32_t line;
+    uint32_t column;
+} meta_cache_field;
+
+typedef struct meta_cache_diagnostic {
+    uint32_t severity;  // META_SEVERITY_*
+    uint32_t code;      // META_DIAG_*
+    uint32_t line;
+    uint32_t column;
+    uint32_t message;   // Offset into the string block
+} meta_cache_diagnostic;
+
+// 64-bit FNV-1a over the whole input
+static uint64_t meta_hash64(const char *data, size_t len) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Returns the cache path for an input: `data.meta` becomes `data.metac`, any
+ * other name gets `.metac` appended. Free the result with `free`.
+ */
+static char *meta_cache_path(const char *input_file) {
+    size_t len = strlen(input_file);
+    int has_ext = len >= 5 && strcmp(input_file + len - 5, ".meta") == 0;
+    char *path = (char *)malloc(len + 7);
+    if (!path) return NULL;
+    memcpy(path, input_file, len);
+    memcpy(path + len, has_ext ? "c" : ".metac", has_ext ? 2 : 7);
+    return path;
+}
+
+typedef struct meta_cache_string {
+    const char *str;  // Interned, so compared by pointer
+    uint32_t offset;
+} meta_cache_string;
+
+/**
+ * Returns the offset of `str` in the string block, appending it on first use.
+ * `seen` is an open-addressing table of `capacity` (a power of two) slots.
+ */
+static uint32_t meta_cache_string_offset(meta_buffer *strings, meta_cache_string *seen, size_t capacity, const char *str) {
+    size_t i = (size_t)(((uintptr_t)str >> 3) * 2654435761u) & (capacity - 1);
+    while (seen[i].str) {
+        if (seen[i].str == str) return seen[i].offset;
+        i = (i + 1) & (capacity - 1);
+    }
+
+    seen[i].str = str;
+    seen[i].offset = (uint32_t)strings->length;
+    meta_buffer_write(strings, str, strlen(str) + 1);
+    return seen[i].offset;
+}
+
+typedef struct meta_cache_writer {
+    meta_buffer tables;
+    meta_buffer strings;
+    meta_cache_string *seen;  // See `meta_cache_string_offset`
+    size_t capacity;
+} meta_cache_writer;
+
+static void meta_cache_put_object(meta_cache_writer *w, const meta_object *obj, uint32_t first_field, uint32_t owner) {
+    meta_cache_object entry;
+    entry.name = meta_cache_string_offset(&w->strings, w->seen, w->capacity, obj->name);
+    entry.first_field = first_field;
+    entry.field_count = (uint32_t)obj->field_count;
+    entry.options = obj->options;
+    entry.align = obj->align_request;
+    entry.pool = obj->pool_capacity;
+    entry.version = obj->version;
+    entry.owner = owner;
+    entry.cacheline = obj->cacheline;
+    entry.line = (uint32_t)obj->line;
+    entry.column = (uint32_t)obj->column;
+    meta_buffer_write(&w->tables, (const char *)&entry, sizeof(entry));
+}
+
+static void meta_cache_put_diagnostic(meta_cache_writer *w, const meta_diagnostic *diag) {
+    meta_cache_diagnostic entry;
+    entry.severity = (uint32_t)diag->severity;
+    entry.code = (uint32_t)diag->code;
+    entry.line = (uint32_t)diag->line;
+    entry.column = (uint32_t)diag->column;
+    entry.message = meta_cache_string_offset(&w->strings, w->seen, w->capacity, diag->message);
+    meta_buffer_write(&w->tables, (const char *)&entry, sizeof(entry));
+}
+
+static void meta_cache_put_fields(meta_cache_writer *w, const meta_object *obj) {
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        meta_cache_field entry;
+        entry.name = meta_cache_string_offset(&w->strings, w->seen, w->capacity, field->name);
+        entry.type = meta_cache_string_offset(&w->strings, w->seen, w->capacity, field->type);
+        entry.flags = (field->name_valid ? META_CACHE_NAME_VALID : 0) |
+                      ((meta_c_name_flags(field->type, strlen(field->type)) & META_C_TYPE) && field->bits >= 0 ? META_CACHE_TYPE_VALID : 0) |
+                      (field->hot > 0 ? META_CACHE_HOT : 0) | (field->hot < 0 ? META_CACHE_COLD : 0);
+        entry.count = (uint32_t)field->count;
+        entry.align = field->align_request;
+        entry.bits = field->bits;
+        entry.line = (uint32_t)field->line;
+        entry.column = (uint32_t)field->column;
+        meta_buffer_write(&w->tables, (const char *)&entry, sizeof(entry));
+    }
+}
+
+/**
+ * Writes the parse result of one input to its cache file, along with the
+ * earlier layouts of its objects and the diagnostics the parser issued, which
+ * `meta_cache_load` issues again.
+ *
+ * @param path        Path of the cache file.
+ * @param hash        Content hash of the input.
+ * @param first       First object parsed from the input.
+ * @param diags       Diagnostics of the parse.
+ * @param diag_count  Number of diagnostics in `diags`.
+ * @return 0 on success, -1 on failure.
+ */
+static int meta_cache_save(const char *path, uint64_t hash, const meta_object *first, const meta_diagnostic *diags, size_t diag_count) {
+    meta_cache_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = META_CACHE_MAGIC;
+    header.version = META_CACHE_VERSION;
+    header.content_hash = hash;
+    header.diagnostic_count = (uint32_t)diag_count;
+
+    for (const meta_object *obj = first; obj; obj = obj->next) {
+        header.object_count++;
+        header.field_count += (uint32_t)obj->field_count;
+        for (const meta_object *prior = obj->prior; prior; prior = prior->prior) {
+            header.prior_count++;
+            header.field_count += (uint32_t)prior->field_count;
+        }
+    }
+
+    meta_cache_writer w;
+    memset(&w, 0, sizeof(w));
+    w.capacity = 64;
+    while (w.capacity < (header.object_count + header.prior_count + header.field_count * 2 + header.diagnostic_count) * 2) w.capacity *= 2;
+    w.seen = (meta_cache_string *)calloc(w.capacity, sizeof(meta_cache_string));
+    if (!w.seen) return -1;
+
+    // Objects first, then the earlier layouts of each; fields follow in the same order
+    uint32_t next_field = 0, owner = 0;
+    for (const meta_object *obj = first; obj; obj = obj->next) {
+        meta_cache_put_object(&w, obj, next_field, obj->cold_of ? (uint32_t)(obj->cold_of->index - first->index) + 1 : 0);
+        next_field += (uint32_t)obj->field_count;
+    }
+    for (const meta_object *obj = first; obj; obj = obj->next, owner++) {
+        for (const meta_object *prior = obj->prior; prior; prior = prior->prior) {
+            meta_cache_put_object(&w, prior, next_field, owner);
+            next_field += (uint32_t)prior->field_count;
+        }
+    }
+    for (const meta_object *obj = first; obj; obj = obj->next) {
+        meta_cache_put_fields(&w, obj);
+    }
+    for (const meta_object *obj = first; obj; obj = obj->next) {
+        for (const meta_object *prior = obj->prior; prior; prior = prior->prior) meta_cache_put_fields(&w, prior);
+    }
+    for (size_t i = 0; i < diag_count; i++) meta_cache_put_diagnostic(&w, &diags[i]);
+    free(w.seen);
+    header.string_bytes = (uint32_t)w.strings.length;
+    if (w.strings.length) meta_buffer_write(&w.tables, w.strings.data, w.strings.length);
+    header.payload_hash = meta_hash64(w.tables.data, w.tables.length);
+
+    meta_buffer out;
+    memset(&out, 0, sizeof(out));
+    meta_buffer_write(&out, (const char *)&header, sizeof(header));
+    if (w.tables.length) meta_buffer_write(&out, w.tables.data, w.tables.length);
+
+    int failed = w.tables.failed || w.strings.failed || out.failed;
+    int result = failed ? -1 : meta_write_file_if_changed(path, out.data, out.length);
+    meta_buffer_free(&w.tables);
+    meta_buffer_free(&w.strings);
+    meta_buffer_free(&out);
+    return result;
+}
+
+typedef struct meta_cache_view {
+    const meta_cache_header *header;
+    const meta_cache_object *objects;  // Objects, then earlier layouts
+    const meta_cache_field *fields;
+    const meta_cache_diagnostic *diagnostics;
+    const char *strings;
+} meta_cache_view;
+
+/**
+ * Checks that a mapped cache file was written by this cache version, is
+ * intact and only refers to things inside itself. The content hash is left
+ * for the caller to compare.
+ *
+ * @param src  The mapped cache file.
+ * @param view Receives the tables of the file.
+ * @return 1 if the file can be read, 0 otherwise.
+ */
+static int meta_cache_check(const meta_source *src, meta_cache_view *view) {
+    const meta_cache_header *header = (const meta_cache_header *)src->data;
+    if (src->size < sizeof(*header) || header->magic != META_CACHE_MAGIC || header->version != META_CACHE_VERSION) return 0;
+
+    size_t total = (size_t)header->object_count + header->prior_count;
+    size_t objects_size = total * sizeof(meta_cache_object);
+    size_t fields_size = (size_t)header->field_count * sizeof(meta_cache_field);
+    size_t diagnostics_size = (size_t)header->diagnostic_count * sizeof(meta_cache_diagnostic);
+    int ok = src->size == sizeof(*header) + objects_size + fields_size + diagnostics_size + header->string_bytes &&
+             (header->string_bytes == 0 || src->data[src->size - 1] == '\0') &&
+             header->payload_hash == meta_hash64(src->data + sizeof(*header), src->size - sizeof(*header));
+    if (!ok) return 0;
+
+    view->header = header;
+    view->objects = (const meta_cache_object *)(src->data + sizeof(*header));
+    view->fields = (const meta_cache_field *)((const char *)view->objects + objects_size);
+    view->diagnostics = (const meta_cache_diagnostic *)((const char *)view->fields + fields_size);
+    view->strings = (const char *)view->diagnostics + diagnostics_size;
+
+    // Validate every offset before anything is registered
+    for (size_t i = 0; ok && i < total; i++) {
+        const meta_cache_object *entry = &view->objects[i];
+        ok = entry->name < header->string_bytes &&
+             entry->first_field <= header->field_count &&
+             entry->field_count <= header->field_count - entry->first_field &&
+             (i < header->object_count ? entry->owner <= i : entry->owner < header->object_count && entry->version);
+    }
+    for (uint32_t i = 0; ok && i < header->field_count; i++) {
+        ok = view->fields[i].name < header->string_bytes && view->fields[i].type < header->string_bytes;
+    }
+    for (uint32_t i = 0; ok && i < header->diagnostic_count; i++) {
+        ok = view->diagnostics[i].message < header->string_bytes;
+    }
+    return ok;
+}
+
+// Copies the fields of one cached object or earlier layout into the context arena
+static void meta_cache_fields(meta_context *ctx, const meta_cache_view *view, const meta_cache_object *entry, meta_object *obj) {
+    size_t count = entry->field_count;
+    if (count) {
+        obj->fields = (meta_field *)meta_arena_alloc(&ctx->arena, count * sizeof(meta_field));
+        obj->field_count = obj->fields ? (int)count : 0;
+    }
+    for (int f = 0; f < obj->field_count; f++) {
+        const meta_cache_field *cached = &view->fields[entry->first_field + (uint32_t)f];
+        const char *field_name = view->strings + cached->name;
+        const char *field_type = view->strings + cached->type;
+        meta_field *field = &obj->fields[f];
+        memset(field, 0, sizeof(*field));
+        field->name = meta_intern(ctx, field_name, strlen(field_name));
+        field->type = meta_intern(ctx, field_type, strlen(field_type));
+        field->name_valid = (cached->flags & META_CACHE_NAME_VALID) != 0;
+        field->type_valid = (cached->flags & META_CACHE_TYPE_VALID) != 0;
+        field->hot = cached->flags & META_CACHE_HOT ? 1 : cached->flags & META_CACHE_COLD ? -1 : 0;
+        field->count = (int)(cached->count & 0x7fffffffu);
+        field->align_request = meta_parse_align((long)cached->align);
+        field->bits = cached->bits;
+        field->line = (int)(cached->line & 0x7fffffffu);
+        field->column = (int)(cached->column & 0x7fffffffu);
+        if (!field->name || !field->type) obj->field_count = f;
+    }
+}
+
+/**
+ * Adds a cached layout to the earlier layouts of `obj`, keeping them oldest
+ * first. Layouts that are not older than `obj`, or whose version is already
+ * there, are skipped. Earlier layouts are not registered as objects.
+ */
+static void meta_cache_add_prior(meta_context *ctx, const meta_cache_view *view, const meta_cache_object *entry, meta_object *obj) {
+    if (!entry->version || entry->version >= obj->version) return;
+    meta_object **link = &obj->prior;
+    while (*link && (*link)->version < entry->version) link = &(*link)->prior;
+    if (*link && (*link)->version == entry->version) return;
+
+    meta_object *prior = (meta_object *)meta_arena_alloc(&ctx->arena, sizeof(*prior));
+    if (!prior) return;
+    memset(prior, 0, sizeof(*prior));
+    prior->name = obj->name;
+    prior->valid = 1;
+    prior->index = obj->index;
+    prior->options = entry->options & META_OPT_REORDER;
+    prior->align_request = entry->align;
+    prior->version = entry->version;
+    meta_cache_fields(ctx, view, entry, prior);
+    prior->prior = *link;
+    *link = prior;
+}
+
+/**
+ * Rebuilds the objects of one input from its cache file, without lexing or
+ * parsing, and issues the diagnostics the parse that wrote it gave. Fails (and registers nothing) unless the cache was written by this
+ * cache version for input bytes with the same content hash.
+ *
+ * @param ctx   The parser context to register the objects in.
+ * @param path  Path of the cache file.
+ * @param hash  Content hash of the current input.
+ * @param first Receives the first loaded object, NULL if the input has none.
+ * @return 1 if the cache was used, 0 on a miss.
+ */
+static int meta_cache_load(meta_context *ctx, const char *path, uint64_t hash, meta_object **first) {
+    meta_source src;
+    if (meta_source_open(&src, path) != 0) return 0;
+
+    meta_cache_view view;
+    int ok = meta_cache_check(&src, &view) && view.header->content_hash == hash;
+    uint32_t count = ok ? view.header->object_count : 0;
+    meta_object **loaded = ok ? (meta_object **)calloc(count ? count : 1, sizeof(meta_object *)) : NULL;
+    ok = ok && loaded;
+
+    meta_object *last = ctx->objects_tail;
+    for (uint32_t i = 0; ok && i < count; i++) {
+        const meta_cache_object *entry = &view.objects[i];
+        const char *name = view.strings + entry->name;
+        meta_object *obj = meta_object_create(ctx, name, strlen(name));
+        loaded[i] = obj;
+        if (!obj) continue;
+        obj->options = entry->options & META_OPT_GENERATE;
+        obj->align_request = entry->align;
+        obj->pool_capacity = entry->pool;
+        obj->version = entry->version;
+        obj->cacheline = entry->cacheline;
+        if (entry->owner) obj->cold_of = loaded[entry->owner - 1];
+        obj->line = (int)(entry->line & 0x7fffffffu);
+        obj->column = (int)(entry->column & 0x7fffffffu);
+        meta_cache_fields(ctx, &view, entry, obj);
+    }
+    for (uint32_t i = 0; ok && i < view.header->prior_count; i++) {
+        const meta_cache_object *entry = &view.objects[count + i];
+        if (loaded[entry->owner]) meta_cache_add_prior(ctx, &view, entry, loaded[entry->owner]);
+    }
+    // The warnings the parser gave when the cache was written still apply
+    for (uint32_t i = 0; ok && i < view.header->diagnostic_count; i++) {
+        const meta_cache_diagnostic *diag = &view.diagnostics[i];
+        meta_diagnose(ctx, (meta_severity)diag->severity, (meta_diagnostic_code)diag->code, (int)diag->line, (int)diag->column, "%s",
+                      view.strings + diag->message);
+    }
+
+    free(loaded);
+    meta_source_close(&src);
+    *first = last ? last->next : ctx->objects;
+    return ok;
+}
+
+/**
+ * Carries the earlier layouts of the `@version` objects starting at `first`
+ * over from the cache file of a previous parse of the input, which may have
+ * changed since. Objects that file holds with a lower version become earlier
+ * layouts too.
+ *
+ * @param ctx   The parser context the objects were registered in.
+ * @param path  Path of the cache file.
+ * @param first First object parsed from the input.
+ */
+static void meta_cache_history(meta_context *ctx, const char *path, meta_object *first) {
+    int versioned = 0;
+    for (const meta_object *obj = first; obj && !versioned; obj = obj->next) versioned = obj->version != 0;
+
+    meta_source src;
+    if (!versioned || meta_source_open(&src, path) != 0) return;
+
+    meta_cache_view view;
+    if (meta_cache_check(&src, &view)) {
+        size_t total = (size_t)view.header->object_count + view.header->prior_count;
+        for (size_t i = 0; i < total; i++) {
+            const char *name = view.strings + view.objects[i].name;
+            meta_intern_entry *entry = meta_intern_entry_for(ctx, name, strlen(name));
+            meta_object *obj = entry ? entry->object : NULL;
+            // Only objects of this parse, not of an earlier one with the same context
+            if (obj && obj->index >= first->index && obj->version) meta_cache_add_prior(ctx, &view, &view.objects[i], obj);
+        }
+    }
+    meta_source_close(&src);
+}
+
+/**
+ * Registers the objects of one already loaded input, taking them from its
+ * cache file when META_OPT_CACHE is set and the input did not change. When it
+ * did, the earlier layouts of its objects are kept, see `meta_cache_history`.
+ *
+ * @param ctx        The parser context.
+ * @param input_file Path the input was loaded from.
+ * @param src        The input bytes.
+ * @return The first object of the input, or NULL if there were none.
+ */
+static meta_object *meta_parse_input(meta_context *ctx, const char *input_file, const meta_source *src) {
+    if (!(ctx->options & META_OPT_CACHE)) return meta_parse_source(ctx, src->data, src->size);
+
+    meta_object *first = NULL;
+    char *cache = meta_cache_path(input_file);
+    uint64_t hash = meta_hash64(src->data, src->size);
+
+    if (!cache || !meta_cache_load(ctx, cache, hash, &first)) {
+        size_t diagnostics = ctx->diagnostic_count;
+        first = meta_parse_source(ctx, src->data, src->size);
+        if (cache) {
+            meta_cache_history(ctx, cache, first);
+            meta_cache_save(cache, hash, first, ctx->diagnostics + diagnostics, ctx->diagnostic_count - diagnostics);
+        }
+    }
+    free(cache);
+    return first;
+}
+
+/**
+ * Parses a metadata file and generates a corresponding C header file with structs.
+ * Objects are registered in `ctx`, which is not shared with any other parse.
+ * The header is only rewritten when its contents change.
+ *
+ * @param ctx         The parser context.
+ * @param input_file  Path to the input metadata file.
+ * @param output_file Path to the output C header file.
+ * @return 0 on success, -1 if an error occurs (e.g., file cannot be opened).
+ */
+int meta_parse_ctx(meta_context *ctx, const char *input_file, const char *output_file) {
+    meta_source src;
+    size_t diagnostics = ctx->diagnostic_count;
+    ctx->input_file = input_file;
+    META_STAT_BEGIN(ctx);
+    if (meta_source_open(&src, input_file) != 0) {
+        meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_IO, 0, 0, "Cannot read input file.");
+        meta_diagnostics_log(ctx, diagnostics);
+        ctx->input_file = NULL;
+        return -1;
+    }
+    META_STAT_PHASE(ctx, io_seconds);
+    META_STAT_INPUT(ctx, src.data, src.size);
+
+    meta_buffer out;
+    memset(&out, 0, sizeof(out));
+    meta_buffer_printf(&out, "/* Auto-generated code - do not edit! */\n\n");
+
+    meta_object *first = meta_parse_input(ctx, input_file, &src);
+    meta_source_close(&src);
+    META_STAT_PHASE(ctx, parse_seconds);
+
+    meta_resolve_objects(ctx, first);
+    META_STAT_PHASE(ctx, resolve_seconds);
+    if (meta_apply_options(first, ctx->options) != 0) out.failed = 1;
+    meta_check_objects(ctx, first);
+    if (!out.failed && meta_write_objects(&out, NULL, first) != 0) out.failed = 1;
+    META_STAT_PHASE(ctx, emit_seconds);
+
+    int result = out.failed ? -1 : meta_write_file_if_changed(output_file, out.data, out.length);
+    meta_buffer_free(&out);
+    META_STAT_PHASE(ctx, io_seconds);
+    if (out.failed) meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_OUT_OF_MEMORY, 0, 0, "Out of memory.");
+    else if (result != 0) meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_IO, 0, 0, "Cannot write '%s'.", output_file);
+    META_STAT_FINISH(ctx, input_file, first);
+    meta_diagnostics_log(ctx, diagnostics);
+    ctx->input_file = NULL;
+    return result;
+}
+
+/**
+ * Parses a metadata file using the default parser context.
+ *
+ * @param input_file  Path to the input metadata file.
+ * @param output_file Path to the output C header file.
+ * @return 0 on success, -1 if an error occurs (e.g., file cannot be opened).
+ */
+int meta_parse(const char *input_file, const char *output_file) {
+    return meta_parse_ctx(&meta_parser_state, input_file, output_file);
+}
+
+/**
+ * Parses metadata held in memory and streams the generated header to a sink,
+ * without touching the filesystem.
+ *
+ * @param ctx  The parser context.
+ * @param src  Start of the metadata text (need not be NUL-terminated).
+ * @param len  Length of the metadata text in bytes.
+ * @param sink Receives the generated code, see `meta_buffer_sink`.
+ * @return 0 on success, -1 if the sink failed or memory ran out.
+ */
+int meta_parse_buffer_ctx(meta_context *ctx, const char *src, size_t len, meta_sink sink) {
+    meta_buffer out;
+    memset(&out, 0, sizeof(out));
+    size_t diagnostics = ctx->diagnostic_count;
+    meta_buffer_printf(&out, "/* Auto-generated code - do not edit! */\n\n");
+    META_STAT_BEGIN(ctx);
+    META_STAT_INPUT(ctx, src, len);
+
+    meta_object *first = meta_parse_source(ctx, src, len);
+    META_STAT_PHASE(ctx, parse_seconds);
+    meta_resolve_objects(ctx, first);
+    META_STAT_PHASE(ctx, resolve_seconds);
+
+    // Chunks flushed to the sink while generating count as emitting
+    int result = meta_apply_options(first, ctx->options);
+    meta_check_objects(ctx, first);
+    if (result == 0) result = meta_write_objects(&out, &sink, first);
+    META_STAT_PHASE(ctx, emit_seconds);
+    if (result == 0) result = meta_buffer_flush(&out, &sink);
+    meta_buffer_free(&out);
+    META_STAT_PHASE(ctx, io_seconds);
+    if (result != 0) meta_diagnose(ctx, META_SEVERITY_ERROR, META_DIAG_IO, 0, 0, "Out of memory or the sink failed.");
+    META_STAT_FINISH(ctx, NULL, first);
+    meta_diagnostics_log(ctx, diagnostics);
+    return result;
+}
+
+/**
+ * Parses metadata held in memory using the default parser context.
+ *
+ * @param src  Start of the metadata text (need not be NUL-terminated).
+ * @param len  Length of the metadata text in bytes.
+ * @param sink Receives the generated code, see `meta_buffer_sink`.
+ * @return 0 on success, -1 if the sink failed or memory ran out.
+ */
+int meta_parse_buffer(const char *src, size_t len, meta_sink sink) {
+    return meta_parse_buffer_ctx(&meta_parser_state, src, len, sink);
+}
+
+/* -------------------------------- BATCH -------------------------------- */
+
+typedef struct meta_registry_entry {
+    const char *name;
+    unsigned int hash;
+    meta_object *object;
+} meta_registry_entry;
+
+/**
+ * Open-addressing map from object name to object, shared by every input of a
+ * batch. It is only written while merging and is read-only afterwards.
+ */
+typedef struct meta_registry {
+    meta_registry_entry *slots;
+    size_t capacity;  // Always a power of two
+} meta_registry;
+
+static meta_registry_entry *meta_registry_slot(const meta_registry *reg, const char *name, unsigned int hash) {
+    size_t i = hash & (reg->capacity - 1);
+    while (reg->slots[i].name) {
+        meta_registry_entry *entry = &reg->slots[i];
+        if (entry->hash == hash && strcmp(entry->name, name) == 0) return entry;
+        i = (i + 1) & (reg->capacity - 1);
+    }
+    return &reg->slots[i];
+}
+
+static meta_object *meta_registry_find(const meta_registry *reg, const char *name) {
+    meta_registry_entry *entry = meta_registry_slot(reg, name, meta_hash_bytes(name, strlen(name)));
+    return entry->object;
+}
+
+typedef struct meta_batch {
+    meta_batch_file *files;
+    meta_context *contexts;
+    meta_object **firsts;  // First object parsed from each input
+    unsigned char *uses;   // count x count, uses[i * count + j] if input i needs input j
+    meta_registry registry;
+    size_t count;
+    unsigned int options;  // Copied into every per-input context
+    const unsigned char *emit;  // Inputs whose header is written, NULL for all
+} meta_batch;
+
+/* Phase one: lex and parse one input into its own context. */
+static void meta_batch_parse(void *user, size_t i) {
+    meta_batch *batch = (meta_batch *)user;
+    meta_source src;
+
+    meta_context_init(&batch->contexts[i]);
+    batch->contexts[i].options = batch->options;
+    batch->contexts[i].input_file = batch->files[i].input_file;
+    batch->firsts[i] = NULL;
+    META_STAT_BEGIN(&batch->contexts[i]);
+    if (meta_source_open(&src, batch->files[i].input_file) != 0) {
+        meta_diagnose(&batch->contexts[i], META_SEVERITY_ERROR, META_DIAG_IO, 0, 0, "Cannot read input file.");
+        batch->files[i].result = -1;
+        return;
+    }
+    META_STAT_PHASE(&batch->contexts[i], io_seconds);
+    META_STAT_INPUT(&batch->contexts[i], src.data, src.size);
+
+    batch->firsts[i] = meta_parse_input(&batch->contexts[i], batch->files[i].input_file, &src);
+    meta_source_close(&src);
+    META_STAT_PHASE(&batch->contexts[i], parse_seconds);
+
+    for (meta_object *obj = batch->firsts[i]; obj; obj = obj->next) {
+        obj->file = (int)i;
+    }
+}
+
+/**
+ * Registers the objects of every input in input order. An object whose name
+ * was already declared by an earlier input becomes a duplicate.
+ *
+ * @return 0 on success, -1 when out of memory.
+ */
+static int meta_batch_merge(meta_batch *batch) {
+    size_t total = 0;
+    for (size_t i = 0; i < batch->count; i++) {
+        total += batch->contexts[i].objects_length;
+    }
+
+    size_t capacity = 64;
+    while (capacity < total * 2) capacity *= 2;
+    batch->registry.slots = (meta_registry_entry *)calloc(capacity, sizeof(meta_registry_entry));
+    batch->registry.capacity = capacity;
+    if (!batch->registry.slots) return -1;
+
+    for (size_t i = 0; i < batch->count; i++) {
+        for (meta_object *obj = batch->firsts[i]; obj; obj = obj->next) {
+            if (obj->duplicate) continue;
+
+            unsigned int hash = meta_hash_bytes(obj->name, strlen(obj->name));
+            meta_registry_entry *entry = meta_registry_slot(&batch->registry, obj->name, hash);
+            if (entry->object) {
+                obj->duplicate = 1;
+                obj->valid = 0;
+            } else {
+                entry->name = obj->name;
+                entry->hash = hash;
+                entry->object = obj;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Phase two: resolve one input against the shared registry. */
+static void meta_batch_resolve(void *user, size_t i) {
+    meta_batch *batch = (meta_batch *)user;
+    unsigned char *uses = batch->uses + i * batch->count;
+
+    META_STAT_START(&batch->contexts[i]);
+    for (meta_object *obj = batch->firsts[i]; obj; obj = obj->next) {
+        for (meta_object *layout = obj; layout; layout = layout->prior) {
+            for (int f = 0; f < layout->field_count; f++) {
+                meta_field *field = &layout->fields[f];
+                meta_object *target = meta_registry_find(&batch->registry, field->type);
+                META_STAT_ADD(&batch->contexts[i], object_lookups, 1);
+                if (meta_resolve_field(field, target) && target->file != (int)i) {
+                    uses[target->file] = 1;
+                }
+            }
+        }
+    }
+    META_STAT_PHASE(&batch->contexts[i], resolve_seconds);
+}
+
+/**
+ * Generated headers cannot include each other in a circle, so any reference
+ * between two inputs that depend on each other (directly or through others)
+ * is dropped again and reported as unresolved.
+ *
+ * @return 0 on success, -1 when out of memory.
+ */
+static int meta_batch_break_cycles(meta_batch *batch) {
+    size_t n = batch->count;
+    unsigned char *reach = (unsigned char *)calloc(n ? n * n : 1, 1);
+    size_t *stack = (size_t *)malloc((n ? n : 1) * sizeof(size_t));
+    if (!reach || !stack) { free(reach); free(stack); return -1; }
+
+    for (size_t from = 0; from < n; from++) {
+        unsigned char *seen = reach + from * n;
+        size_t top = 0;
+        stack[top++] = from;
+        while (top) {
+            size_t at = stack[--top];
+            for (size_t to = 0; to < n; to++) {
+                if (batch->uses[at * n + to] && !seen[to]) {
+                    seen[to] = 1;
+                    stack[top++] = to;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        for (meta_object *obj = batch->firsts[i]; obj; obj = obj->next) {
+            for (int f = 0; f < obj->field_count; f++) {
+                meta_field *field = &obj->fields[f];
+                if (!field->object || field->object->file == (int)i) continue;
+                if (!reach[(size_t)field->object->file * n + i]) continue;
+
+                field->object = NULL;
+                field->type_valid = (meta_c_name_flags(field->type, strlen(field->type)) & META_C_TYPE) != 0;
+            }
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            if (reach[i * n + j] && reach[j * n + i]) batch->uses[i * n + j] = 0;
+        }
+    }
+
+    free(reach);
+    free(stack);
+    return 0;
+}
+
+// Include path of `target` as seen from `from`: the bare file name when both
+// headers live in the same directory, the path as given otherwise.
+static const char *meta_batch_include_path(const char *from, const char *target) {
+    const char *from_base = from, *target_base = target;
+    for (const char *p = from; *p; p++) if (*p == '/' || *p == '\\') from_base = p + 1;
+    for (const char *p = target; *p; p++) if (*p == '/' || *p == '\\') target_base = p + 1;
+
+    size_t from_dir = (size_t)(from_base - from), target_dir = (size_t)(target_base - target);
+    if (from_dir == target_dir && strncmp(from, target, from_dir) == 0) return target_base;
+    return target;
+}
+
+/* Phase three: write the header of one input, including the headers it uses. */
+static void meta_batch_emit(void *user, size_t i) {
+    meta_batch *batch = (meta_batch *)user;
+    meta_batch_file *file = &batch->files[i];
+    const unsigned char *uses = batch->uses + i * batch->count;
+    if (file->result != 0 || (batch->emit && !batch->emit[i])) return;
+
+    meta_buffer out;
+    memset(&out, 0, sizeof(out));
+    meta_buffer_printf(&out, "/* Auto-generated code - do not edit! */\n\n#pragma once\n\n");
+    int includes = 0;
+    for (size_t j = 0; j < batch->count; j++) {
+        if (!uses[j]) continue;
+        meta_buffer_printf(&out, "#include \"%s\"\n", meta_batch_include_path(file->output_file, batch->files[j].output_file));
+        includes = 1;
+    }
+    if (includes) meta_buffer_printf(&out, "\n");
+
+    META_STAT_START(&batch->contexts[i]);
+    if (meta_write_objects(&out, NULL, batch->firsts[i]) != 0) out.failed = 1;
+    META_STAT_PHASE(&batch->contexts[i], emit_seconds);
+    file->result = out.failed ? -1 : meta_write_file_if_changed(file->output_file, out.data, out.length);
+    meta_buffer_free(&out);
+    META_STAT_PHASE(&batch->contexts[i], io_seconds);
+    if (out.failed) meta_diagnose(&batch->contexts[i], META_SEVERITY_ERROR, META_DIAG_OUT_OF_MEMORY, 0, 0, "Out of memory.");
+    else if (file->result != 0) meta_diagnose(&batch->contexts[i], META_SEVERITY_ERROR, META_DIAG_IO, 0, 0, "Cannot write '%s'.", file->output_file);
+}
+
+typedef struct meta_pool {
+    void (*job)(void *user, size_t index);
+    void *user;
+    size_t count;
+    size_t next;
+#if defined(META_PARSER_THREADS) && defined(_WIN32)
+    CRITICAL_SECTION lock;
+#elif defined(META_PARSER_THREADS)
+    pthread_mutex_t lock;
+#endif
+} meta_pool;
+
+static int meta_pool_take(meta_pool *pool, size_t *index) {
+#if defined(META_PARSER_THREADS) && defined(_WIN32)
+    EnterCriticalSection(&pool->lock);
+    *index = pool->next++;
+    LeaveCriticalSection(&pool->lock);
+#elif defined(META_PARSER_THREADS)
+    pthread_mutex_lock(&pool->lock);
+    *index = pool->next++;
+    pthread_mutex_unlock(&pool->lock);
+#else
+    *index = pool->next++;
+#endif
+    return *index < pool->count;
+}
+
+static void meta_pool_work(meta_pool *pool) {
+    size_t index;
+    while (meta_pool_take(pool, &index)) pool->job(pool->user, index);
+}
+
+#if defined(META_PARSER_THREADS) && defined(_WIN32)
+static DWORD WINAPI meta_pool_thread(LPVOID arg) { meta_pool_work((meta_pool *)arg); return 0; }
+#elif defined(META_PARSER_THREADS)
+static void *meta_pool_thread(void *arg) { meta_pool_work((meta_pool *)arg); return NULL; }
+#endif
+
+/**
+ * Runs `job` for every index in [0, count) on up to `threads` threads,
+ * including the calling one. Without META_PARSER_THREADS the jobs run in order
+ * on the calling thread.
+ */
+static void meta_pool_run(void (*job)(void *, size_t), void *user, size_t count, int threads) {
+    meta_pool pool;
+    pool.job = job;
+    pool.user = user;
+    pool.count = count;
+    pool.next = 0;
+
+#if defined(META_PARSER_THREADS)
+    if (threads <= 0) {
+    #ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        threads = (int)info.dwNumberOfProcessors;
+    #else
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    #endif
+    }
+    if ((size_t)threads > count) threads = (int)count;
+    if (threads > 1) {
+        int started = 0;
+    #ifdef _WIN32
+        HANDLE *handles = (HANDLE *)malloc((size_t)threads * sizeof(HANDLE));
+        InitializeCriticalSection(&pool.lock);
+        for (int t = 1; handles && t < threads; t++) {
+            handles[started] = CreateThread(NULL, 0, meta_pool_thread, &pool, 0, NULL);
+            if (handles[started]) started++;
+        }
+        meta_pool_work(&pool);
+        if (started) WaitForMultipleObjects((DWORD)started, handles, TRUE, INFINITE);
+        for (int t = 0; t < started; t++) CloseHandle(handles[t]);
+        DeleteCriticalSection(&pool.lock);
+    #else
+        pthread_t *handles = (pthread_t *)malloc((size_t)threads * sizeof(pthread_t));
+        pthread_mutex_init(&pool.lock, NULL);
+        for (int t = 1; handles && t < threads; t++) {
+            if (pthread_create(&handles[started], NULL, meta_pool_thread, &pool) == 0) started++;
+        }
+        meta_pool_work(&pool);
+        for (int t = 0; t < started; t++) pthread_join(handles[t], NULL);
+        pthread_mutex_destroy(&pool.lock);
+    #endif
+        free(handles);
+        return;
+    }
+    #ifdef _WIN32
+    InitializeCriticalSection(&pool.lock);
+    meta_pool_work(&pool);
+    DeleteCriticalSection(&pool.lock);
+    #else
+    pthread_mutex_init(&pool.lock, NULL);
+    meta_pool_work(&pool);
+    pthread_mutex_destroy(&pool.lock);
+    #endif
+#else
+    (void)threads;
+    meta_pool_work(&pool);
+#endif
+}
+
+/**
+ * Moves the diagnostics of every input of a batch into `ctx`, in input order,
+ * printing each input's in one go with META_LOG_CONSOLE.
+ */
+static void meta_batch_diagnostics(meta_context *ctx, const meta_batch *batch) {
+    for (size_t i = 0; i < batch->count; i++) {
+        const meta_context *file = &batch->contexts[i];
+        meta_diagnostics_log(file, 0);
+        // Messages live in the arena of the input's context, which is about to be freed
+        ctx->input_file = batch->files[i].input_file;
+        for (size_t d = 0; d < file->diagnostic_count; d++) {
+            const meta_diagnostic *diag = &file->diagnostics[d];
+            meta_diagnose(ctx, diag->severity, diag->code, diag->line, diag->column, "%s", diag->message);
+        }
+    }
+    ctx->input_file = NULL;
+}
+
+#ifdef META_PARSER_STATS
+/**
+ * Hands the statistics of every input of a batch to the callback of `ctx`, in
+ * input order on the calling thread, and sums them up in `ctx->stats`.
+ */
+static void meta_stats_batch(meta_context *ctx, meta_batch *batch) {
+    meta_stats *total = &ctx->stats;
+    memset(total, 0, sizeof(*total));
+    for (size_t i = 0; i < batch->count; i++) {
+        meta_context *file = &batch->contexts[i];
+        file->stats_callback = ctx->stats_callback;
+        file->stats_user = ctx->stats_user;
+        meta_stats_finish(file, batch->files[i].input_file, batch->firsts[i]);
+
+        const meta_stats *stats = &file->stats;
+        total->io_seconds += stats->io_seconds;
+        total->parse_seconds += stats->parse_seconds;
+        total->resolve_seconds += stats->resolve_seconds;
+        total->emit_seconds += stats->emit_seconds;
+        total->bytes += stats->bytes;
+        total->lines += stats->lines;
+        total->objects += stats->objects;
+        total->fields += stats->fields;
+        total->object_lookups += stats->object_lookups;
+        total->c_type_lookups += stats->c_type_lookups;
+        total->errors += stats->errors;
+    }
+}
+#endif
+
+/**
+ * Merges the objects of every parsed input of a batch, resolves each input
+ * against them and lays them out, leaving the batch ready to be written.
+ *
+ * @return 0 on success, -1 when out of memory.
+ */
+static int meta_batch_link(meta_batch *batch, int threads) {
+    if (meta_batch_merge(batch) != 0) return -1;
+    meta_pool_run(meta_batch_resolve, batch, batch->count, threads);
+    if (meta_batch_break_cycles(batch) != 0) return -1;
+    for (size_t i = 0; i < batch->count; i++) {
+        META_STAT_START(&batch->contexts[i]);
+        int failed = meta_apply_options(batch->firsts[i], batch->options) != 0;
+        meta_check_objects(&batch->contexts[i], batch->firsts[i]);
+        META_STAT_PHASE(&batch->contexts[i], emit_seconds);
+        if (failed) return -1;
+    }
+    return 0;
+}
+
+/**
+ * Parses many metadata files whose objects may reference each other, writing
+ * one header per input. All inputs are first parsed in parallel, their object
+ * names are then merged into one registry, and finally every input is resolved
+ * and written in parallel. A header that uses objects from other inputs
+ * includes their headers; references that would make headers include each
+ * other in a circle are left unresolved.
+ *
+ * @param ctx     Context whose options apply to every input. Each input is
+ *                parsed in a context of its own, `ctx` itself only receives
+ *                the diagnostics of every input and, with META_PARSER_STATS,
+ *                the sum of their `stats`.
+ * @param files   Inputs and outputs; each `result` is set on return.
+ * @param count   Number of entries in `files`.
+ * @param threads Worker threads to use, 0 for one per CPU. Only honoured when
+ *                META_PARSER_THREADS is defined, otherwise files are processed
+ *                one after another.
+ * @return 0 if every file succeeded, -1 otherwise.
+ */
+int meta_parse_batch(meta_context *ctx, meta_batch_file *files, size_t count, int threads) {
+    meta_batch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.options = ctx->options;
+    batch.files = files;
+    batch.count = count;
+    batch.contexts = (meta_context *)malloc((count ? count : 1) * sizeof(meta_context));
+    batch.firsts = (meta_object **)malloc((count ? count : 1) * sizeof(meta_object *));
+    batch.uses = (unsigned char *)calloc(count ? count * count : 1, 1);
+
+    for (size_t i = 0; i < count; i++) files[i].result = 0;
+
+    int ok = batch.contexts && batch.firsts && batch.uses;
+    if (ok) {
+        meta_pool_run(meta_batch_parse, &batch, count, threads);
+        ok = meta_batch_link(&batch, threads) == 0;
+        if (ok) meta_pool_run(meta_batch_emit, &batch, count, threads);
+        if (ok) META_STAT_BATCH(ctx, &batch);
+        meta_batch_diagnostics(ctx, &batch);
+        for (size_t i = 0; i < count; i++) meta_context_free(&batch.contexts[i]);
+    }
+
+    int result = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!ok) files[i].result = -1;
+        if (files[i].result != 0) result = -1;
+    }
+
+    free(batch.registry.slots);
+    free(batch.contexts);
+    free(batch.firsts);
+    free(batch.uses);
+    return result;
+}
+
+/* -------------------------------- WATCH -------------------------------- */
+
+/* One object or earlier layout of an input as it was parsed, before linking changed it. */
+typedef struct meta_watch_saved {
+    meta_object *object;
+    meta_field *fields;   // Copy in the arena of the input's context
+    unsigned int options;
+    int valid;
+    int duplicate;
+} meta_watch_saved;
+
+typedef struct meta_watch_input {
+    uint64_t hash;             // Contents as last parsed
+    int readable;              // Whether the input could be read then
+    int changed;               // To be parsed again by the next build
+    meta_watch_saved *saved;
+    size_t saved_count;
+    size_t diagnostics;        // Of its context once parsed, those of linking come after
+    uint64_t *signatures;      // Per object, by `index`, 0 until computed by the current build
+    uint64_t header;           // Signature of the header as last written, 0 if never written
+    int wd;                    // inotify watch on its directory, -1 without
+    const char *name;          // File name within that directory
+} meta_watch_input;
+
+typedef struct meta_watch_state {
+    meta_batch batch;
+    meta_watch_input *inputs;
+    unsigned char *emit;
+    int threads;
+    int failed;  // A parse ran out of memory
+    int fd;      // inotify descriptor, -1 when polling
+} meta_watch_state;
+
+// Reads an input and hashes its contents, 0 if it cannot be read
+static int meta_watch_read(const char *path, uint64_t *hash) {
+    meta_source src;
+    *hash = 0;
+    if (meta_source_open(&src, path) != 0) return 0;
+    *hash = meta_hash64(src.data, src.size);
+    meta_source_close(&src);
+    return 1;
+}
+
+/**
+ * Rereads every input marked in `candidates` (all of them when NULL) and
+ * marks those whose contents differ from their last parse as changed.
+ *
+ * @return Number of changed inputs.
+ */
+static size_t meta_watch_check(meta_watch_state *state, const unsigned char *candidates) {
+    size_t changed = 0;
+    for (size_t i = 0; i < state->batch.count; i++) {
+        meta_watch_input *input = &state->inputs[i];
+        uint64_t hash;
+        if (candidates && !candidates[i]) continue;
+        int readable = meta_watch_read(state->batch.files[i].input_file, &hash);
+        if (readable == input->readable && hash == input->hash) continue;
+        input->hash = hash;
+        input->readable = readable;
+        input->changed = 1;
+        changed++;
+    }
+    return changed;
+}
+
+/* Parses one changed input again and keeps what it parsed, see `meta_watch_restore`. */
+static void meta_watch_parse(void *user, size_t i) {
+    meta_watch_state *state = (meta_watch_state *)user;
+    meta_watch_input *input = &state->inputs[i];
+    meta_context *ctx = &state->batch.contexts[i];
+    if (!input->changed) return;
+
+    meta_context_free(ctx);
+    state->batch.files[i].result = 0;
+    meta_batch_parse(&state->batch, i);
+    input->readable = state->batch.files[i].result == 0;  // It may have gone since it was checked
+
+    size_t count = 0;
+    for (meta_object *obj = state->batch.firsts[i]; obj; obj = obj->next) {
+        for (meta_object *layout = obj; layout; layout = layout->prior) count++;
+    }
+    free(input->saved);
+    free(input->signatures);
+    input->saved = (meta_watch_saved *)malloc((count ? count : 1) * sizeof(meta_watch_saved));
+    input->signatures = (uint64_t *)malloc((ctx->objects_length ? ctx->objects_length : 1) * sizeof(uint64_t));
+    input->saved_count = 0;
+    input->diagnostics = ctx->diagnostic_count;
+    if (!input->saved || !input->signatures) { state->failed = 1; return; }
+
+    for (meta_object *obj = state->batch.firsts[i]; obj; obj = obj->next) {
+        for (meta_object *layout = obj; layout; layout = layout->prior) {
+            meta_watch_saved *saved = &input->saved[input->saved_count++];
+            size_t size = (size_t)layout->field_count * sizeof(meta_field);
+            saved->object = layout;
+            saved->fields = size ? (meta_field *)meta_arena_alloc(&ctx->arena, size) : NULL;
+            saved->options = layout->options;
+            saved->valid = layout->valid;
+            saved->duplicate = layout->duplicate;
+            if (size && !saved->fields) { state->failed = 1; return; }
+            if (size) memcpy(saved->fields, layout->fields, size);
+        }
+    }
+}
+
+/**
+ * Puts the objects of an unchanged input back the way they were parsed, undoing
+ * what linking did to them in the last build: resolved types, inherited
+ * options, reordered members, layouts and duplicates found across inputs.
+ */
+static void meta_watch_restore(meta_watch_state *state, size_t i) {
+    meta_watch_input *input = &state->inputs[i];
+    meta_context *ctx = &state->batch.contexts[i];
+    for (size_t s = 0; s < input->saved_count; s++) {
+        const meta_watch_saved *saved = &input->saved[s];
+        meta_object *obj = saved->object;
+        if (obj->field_count) memcpy(obj->fields, saved->fields, (size_t)obj->field_count * sizeof(meta_field));
+        obj->options = saved->options;
+        obj->valid = saved->valid;
+        obj->duplicate = saved->duplicate;
+        obj->layout = 0;
+    }
+    ctx->diagnostic_count = input->diagnostics;
+#ifdef META_PARSER_STATS
+    memset(&ctx->stats, 0, sizeof(ctx->stats));  // Nothing was read or parsed for it this time
+#endif
+}
+
+// FNV-1a over `len` bytes, continued from `hash`
+static uint64_t meta_watch_mix(uint64_t hash, const void *data, size_t len) {
+    for (size_t i = 0; i < len; i++) hash = (hash ^ ((const unsigned char *)data)[i]) * 1099511628211ull;
+    return hash;
+}
+
+static uint64_t meta_watch_number(uint64_t hash, uint64_t value) {
+    return meta_watch_mix(hash, &value, sizeof(value));
+}
+
+static uint64_t meta_watch_signature(meta_watch_state *state, meta_object *obj);
+
+// Hashes everything code generation reads from one layout of an object
+static uint64_t meta_watch_layout(meta_watch_state *state, uint64_t hash, const meta_object *obj) {
+    hash = meta_schema_hash(meta_schema_hash(hash, obj->name), obj->scalar ? obj->scalar : "");
+    hash = meta_watch_number(hash, (uint64_t)obj->valid << 1 | (uint64_t)obj->duplicate << 2 | (uint64_t)obj->bitfields << 3);
+    hash = meta_watch_number(hash, obj->options);
+    hash = meta_watch_number(hash, (uint64_t)obj->align_request << 32 | obj->pool_capacity);
+    hash = meta_watch_number(hash, obj->version);
+    hash = meta_watch_number(hash, obj->size);
+    hash = meta_watch_number(hash, obj->align);
+    hash = meta_watch_number(hash, obj->schema);
+    hash = meta_watch_number(hash, (uint64_t)obj->field_count);
+    for (int i = 0; i < obj->field_count; i++) {
+        const meta_field *field = &obj->fields[i];
+        hash = meta_schema_hash(meta_schema_hash(meta_schema_hash(hash, field->name), ":"), field->type);
+        hash = meta_watch_number(hash, (uint64_t)(uint32_t)field->count << 32 | (uint32_t)field->bits);
+        hash = meta_watch_number(hash, field->align_request);
+        hash = meta_watch_number(hash, (uint64_t)field->name_valid | (uint64_t)field->type_valid << 1 | (uint64_t)field->cyclic << 2);
+        hash = meta_watch_number(hash, field->object ? meta_watch_signature(state, field->object) : 0);
+    }
+    return hash;
+}
+
+/**
+ * Signature of an object once linked: its own layouts and, through their
+ * members, the signatures of every object it holds. Equal signatures mean the
+ * generated code for the object is the same. Computed once per build.
+ */
+static uint64_t meta_watch_signature(meta_watch_state *state, meta_object *obj) {
+    uint64_t *memo = &state->inputs[obj->file].signatures[obj->index];
+    if (*memo) return *memo;
+
+    uint64_t hash = 14695981039346656037ull;
+    for (const meta_object *layout = obj; layout; layout = layout->prior) hash = meta_watch_layout(state, hash, layout);
+    *memo = hash ? hash : 1;
+    return *memo;
+}
+
+// Signature of the header of one input: its includes and the signatures of its objects
+static uint64_t meta_watch_header(meta_watch_state *state, size_t i) {
+    const meta_batch *batch = &state->batch;
+    uint64_t hash = meta_watch_mix(14695981039346656037ull, batch->uses + i * batch->count, batch->count);
+    for (meta_object *obj = batch->firsts[i]; obj; obj = obj->next) {
+        hash = meta_watch_number(hash, meta_watch_signature(state, obj));
+    }
+    return hash ? hash : 1;
+}
+
+/**
+ * Parses the changed inputs again, links every input and writes the headers
+ * whose signature changed, see `meta_watch_header`. Headers that failed to be
+ * written last time are tried again.
+ *
+ * @return Number of headers written, or -1 when out of memory.
+ */
+static int meta_watch_build(meta_watch *watch) {
+    meta_watch_state *state = watch->state;
+    meta_batch *batch = &state->batch;
+    size_t count = batch->count;
+
+    state->failed = 0;
+    meta_pool_run(meta_watch_parse, state, count, state->threads);
+    if (state->failed) return -1;
+    for (size_t i = 0; i < count; i++) {
+        if (!state->inputs[i].changed) meta_watch_restore(state, i);
+    }
+
+    free(batch->registry.slots);
+    batch->registry.slots = NULL;
+    memset(batch->uses, 0, count * count);
+    if (meta_batch_link(batch, state->threads) != 0) return -1;
+
+    for (size_t i = 0; i < count; i++) {
+        meta_watch_input *input = &state->inputs[i];
+        size_t objects = batch->contexts[i].objects_length;
+        memset(input->signatures, 0, (objects ? objects : 1) * sizeof(uint64_t));
+    }
+    int written = 0;
+    for (size_t i = 0; i < count; i++) {
+        meta_watch_input *input = &state->inputs[i];
+        input->changed = 0;
+        state->emit[i] = 0;
+        if (!input->readable) {
+            batch->files[i].result = -1;
+            input->header = 0;
+            continue;
+        }
+        uint64_t header = meta_watch_header(state, i);
+        if (header == input->header && batch->files[i].result == 0) continue;
+        input->header = header;
+        batch->files[i].result = 0;
+        state->emit[i] = 1;
+    }
+    meta_pool_run(meta_batch_emit, batch, count, state->threads);
+    for (size_t i = 0; i < count; i++) {
+        if (!state->emit[i]) continue;
+        if (batch->files[i].result == 0) written++;
+        else state->inputs[i].header = 0;
+    }
+
+    meta_context_free(&watch->report);
+    META_STAT_BATCH(&watch->report, batch);
+    meta_batch_diagnostics(&watch->report, batch);
+    return written;
+}
+
+/**
+ * Starts watching the inputs of a batch: runs it once, like `meta_parse_batch`,
+ * then keeps every input parsed and linked in memory so `meta_watch_wait` can
+ * bring the headers up to date when inputs change. On Linux the directories
+ * of the inputs are watched with inotify, elsewhere (or with
+ * META_PARSER_NO_INOTIFY defined) the inputs are reread every
+ * META_PARSER_WATCH_POLL_MS milliseconds.
+ *
+ * @param watch   Watch to set up, released with `meta_watch_free`.
+ * @param ctx     Context whose options, and stats callback with
+ *                META_PARSER_STATS, apply to every build.
+ * @param files   Inputs and outputs; must outlive the watch. Each `result`
+ *                is updated by every build.
+ * @param count   Number of entries in `files`.
+ * @param threads As for `meta_parse_batch`.
+ * @return 0 if the watch was set up, even when some inputs failed (see their
+ *         `result` and `watch->report`), -1 when out of memory.
+ */
+int meta_watch_init(meta_watch *watch, const meta_context *ctx, meta_batch_file *files, size_t count, int threads) {
+    meta_context_init(&watch->report);
+    watch->report.options = ctx->options;
+#ifdef META_PARSER_STATS
+    watch->report.stats_callback = ctx->stats_callback;
+    watch->report.stats_user = ctx->stats_user;
+#endif
+    meta_watch_state *state = (meta_watch_state *)calloc(1, sizeof(meta_watch_state));
+    watch->state = state;
+    if (!state) return -1;
+
+    size_t slots = count ? count : 1;
+    state->threads = threads;
+    state->fd = -1;
+    state->batch.options = ctx->options;
+    state->batch.files = files;
+    state->batch.count = count;
+    state->batch.contexts = (meta_context *)calloc(slots, sizeof(meta_context));
+    state->batch.firsts = (meta_object **)calloc(slots, sizeof(meta_object *));
+    state->batch.uses = (unsigned char *)calloc(count ? count * count : 1, 1);
+    state->batch.emit = state->emit = (unsigned char *)calloc(slots, 1);
+    state->inputs = (meta_watch_input *)calloc(slots, sizeof(meta_watch_input));
+    if (!state->batch.contexts || !state->batch.firsts || !state->batch.uses || !state->emit || !state->inputs) {
+        meta_watch_free(watch);
+        return -1;
+    }
+
+#ifdef META_PARSER_USE_INOTIFY
+    state->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    for (size_t i = 0; i < count; i++) {
+        meta_watch_input *input = &state->inputs[i];
+        const char *path = files[i].input_file;
+        input->name = path;
+        for (const char *p = path; *p; p++) if (*p == '/' || *p == '\\') input->name = p + 1;
+        input->wd = -1;
+#ifdef META_PARSER_USE_INOTIFY
+        if (state->fd >= 0) {
+            size_t dir = (size_t)(input->name - path);
+            char *name = (char *)malloc(dir + 2);
+            if (name) {
+                if (dir) memcpy(name, path, dir);
+                else name[dir++] = '.';
+                name[dir] = '\0';
+                // Editors often save by renaming a new file over the old one, so watch the directory
+                input->wd = inotify_add_watch(state->fd, name, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM);
+                free(name);
+            }
+        }
+#endif
+        input->readable = meta_watch_read(path, &input->hash);
+        input->changed = 1;
+        files[i].result = 0;
+    }
+
+    if (meta_watch_build(watch) < 0) {
+        meta_watch_free(watch);
+        return -1;
+    }
+    return 0;
+}
+
+#ifdef META_PARSER_USE_INOTIFY
+// Marks the inputs named by the pending inotify events, returns -1 on failure
+static int meta_watch_events(meta_watch_state *state, unsigned char *candidates) {
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        ssize_t n = read(state->fd, buf, sizeof(buf));
+        if (n < 0) return errno == EAGAIN || errno == EINTR ? 0 : -1;
+        for (ssize_t at = 0; at < n;) {
+            const struct inotify_event *event = (const struct inotify_event *)(buf + at);
+            for (size_t i = 0; i < state->batch.count; i++) {
+                const meta_watch_input *input = &state->inputs[i];
+                // Events were lost, so any input may have changed
+                if (event->mask & IN_Q_OVERFLOW) candidates[i] = 1;
+                else if (event->len && event->wd == input->wd && strcmp(event->name, input->name) == 0) candidates[i] = 1;
+            }
+            at += (ssize_t)(sizeof(struct inotify_event) + event->len);
+        }
+    }
+}
+#endif
+
+// Sleeps for `ms` milliseconds
+static void meta_watch_sleep(int ms) {
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#elif defined(__unix__) || defined(__APPLE__)
+    poll(NULL, 0, ms);
+#else
+    (void)ms;  // Nothing to sleep with, polls again right away
+#endif
+}
+
+/**
+ * Waits until inputs of a watch change, or `timeout_ms` passes, and brings
+ * the headers up to date. Only the inputs whose contents changed are parsed
+ * again. Every input is then linked anew, and only headers whose objects, or
+ * objects they hold, come out different are written. Comment-only edits
+ * write nothing. `watch->report` is replaced with the diagnostics of all
+ * inputs after a build, and left alone when nothing changed.
+ *
+ * @param watch      Watch set up with `meta_watch_init`.
+ * @param timeout_ms Longest time to wait, negative to wait for a change.
+ * @return Number of headers written, 0 if no input changed (with inotify this
+ *         can happen before the timeout, when only other files in the same
+ *         directories changed), or -1 if the watch failed (out of memory, or
+ *         inotify broke down).
+ */
+int meta_watch_wait(meta_watch *watch, int timeout_ms) {
+    meta_watch_state *state = watch->state;
+    if (!state) return -1;
+
+#ifdef META_PARSER_USE_INOTIFY
+    if (state->fd >= 0) {
+        unsigned char *candidates = (unsigned char *)calloc(state->batch.count ? state->batch.count : 1, 1);
+        struct pollfd pfd;
+        pfd.fd = state->fd;
+        pfd.events = POLLIN;
+        if (!candidates) return -1;
+
+        int ready = poll(&pfd, 1, timeout_ms < 0 ? -1 : timeout_ms);
+        while (ready > 0) {
+            if (meta_watch_events(state, candidates) != 0) { free(candidates); return -1; }
+            ready = poll(&pfd, 1, META_PARSER_WATCH_SETTLE_MS);
+        }
+        if (ready < 0 && errno != EINTR) { free(candidates); return -1; }
+        size_t changed = meta_watch_check(state, candidates);
+        free(candidates);
+        return changed ? meta_watch_build(watch) : 0;
+    }
+#endif
+
+    for (int waited = 0;; waited += META_PARSER_WATCH_POLL_MS) {
+        if (meta_watch_check(state, NULL)) {
+            meta_watch_sleep(META_PARSER_WATCH_SETTLE_MS);
+            meta_watch_check(state, NULL);
+            return meta_watch_build(watch);
+        }
+        if (timeout_ms >= 0 && waited >= timeout_ms) return 0;
+        meta_watch_sleep(META_PARSER_WATCH_POLL_MS);
+    }
+}
+
+/**
+ * Stops watching and releases everything a watch holds, `report` included.
+ * Objects and diagnostics obtained from it become invalid.
+ */
+void meta_watch_free(meta_watch *watch) {
+    meta_watch_state *state = watch->state;
+    meta_context_free(&watch->report);
+    watch->state = NULL;
+    if (!state) return;
+
+#ifdef META_PARSER_USE_INOTIFY
+    if (state->fd >= 0) close(state->fd);
+#endif
+    for (size_t i = 0; state->inputs && i < state->batch.count; i++) {
+        free(state->inputs[i].saved);
+        free(state->inputs[i].signatures);
+    }
+    for (size_t i = 0; state->batch.contexts && i < state->batch.count; i++) {
+        meta_context_free(&state->batch.contexts[i]);
+    }
+    free(state->batch.registry.slots);
+    free(state->batch.contexts);
+    free(state->batch.firsts);
+    free(state->batch.uses);
+    free(state->emit);
+    free(state->inputs);
+    free(state);
 }
 
 #endif /* META_PARSER_IMPLEMENTATION */
 
 /*
     Revision history:
+        2.24.0 (2026-10-14)  Add `@cacheline` object alignment, and `@hot`
+                             and `@cold` fields, grouping hot members up
+                             front and moving cold ones to `XColdData`.
+        2.23.0 (2026-10-14)  Add `@cpp`, generating a C++ `meta::schema`
+                             specialization with constexpr member
+                             descriptors, `visit` and `serialize`.
+                             `_Bool` members compile as C++.
+        2.22.0 (2026-10-14)  Add `meta_watch_init` and `meta_watch_wait`,
+                             keeping a batch resident and rebuilding only
+                             the inputs and headers that changed.
+        2.21.0 (2026-10-14)  Collect warnings and errors as `meta_diagnostic`
+                             records with file, line and column in the
+                             context; META_LOG_CONSOLE prints them per parse.
+        2.20.0 (2026-10-14)  Add `META_PARSER_STATS`, recording per-phase
+                             timings and counters in `meta_stats` with an
+                             optional callback per parse.
+        2.19.0 (2026-10-14)  Add `@version(N)`, keeping earlier layouts in
+                             the schema cache and generating migrations that
+                             copy unchanged runs of members in one go.
+        2.18.0 (2026-10-14)  Add `@text` / META_OPT_TEXT, generating text
+                             instance loaders with perfect-hash dispatch.
+        2.17.0 (2026-10-14)  Add `@view` / META_OPT_VIEW, generating
+                             zero-copy accessors over serialized buffers.
+        2.16.0 (2026-10-14)  Add `@little_endian` / META_OPT_LITTLE_ENDIAN,
+                             a host-independent wire format with SIMD byte
+                             swaps on big-endian hosts.
+        2.15.0 (2026-10-14)  Add `@pool(N)`, generating a fixed-capacity
+                             pool with generational handles.
+        2.14.0 (2026-10-14)  Add `@hash` / META_OPT_HASH, generating
+                             padding-safe `XData_eq` and `XData_hash`.
+        2.13.0 (2026-10-14)  Add `@delta` / META_OPT_DELTA, generating dirty
+                             masks, setters and delta encoding.
+        2.12.0 (2026-10-14)  Add `@reflect` / META_OPT_REFLECT, generating
+                             `XData_fields` tables and C++ `meta_for_each_field`.
+        2.11.0 (2026-10-14)  Add bitfields, with an explicit width
+                             (`_Bool : 1`) or a value range (`int [0..100]`).
+        2.10.0 (2026-10-14)  Field types run to the end of the line, so
+                             `long long` and friends are no longer cut
+                             short. Add <stdint.h> types and the aliases
+                             u8 .. u64, i8 .. i64, f32 and f64.
+        2.9.0  (2026-10-14)  Add fixed-size array fields (`float[64]`) and
+                             `@align(N)` on fields and objects, emitted
+                             as `_Alignas`.
+        2.8.0  (2026-10-14)  Add `@soa` / META_OPT_SOA, generating a
+                             structure-of-arrays container per object.
+        2.7.0  (2026-10-14)  Add `@reorder` / META_OPT_REORDER to sort
+                             members by alignment, and static asserts on
+                             the computed struct layout.
+        2.6.0  (2026-10-14)  Add object attributes and `@serialize` /
+                             META_OPT_SERIALIZE, generating binary read
+                             and write functions with a memcpy fast path.
+        2.5.0  (2026-10-14)  Add META_OPT_CACHE, a binary `.metac` cache
+                             of each parsed input keyed by its content
+                             hash. `meta_parse_batch` takes a context.
+        2.4.0  (2026-10-14)  Resolve object types declared later in the
+                             file and write structs in dependency order,
+                             commenting out circular by-value members.
+        2.3.0  (2026-10-14)  Add `meta_parse_batch` to parse many files
+                             whose objects reference each other, in par-
+                             allel when META_PARSER_THREADS is defined.
+        2.2.0  (2026-10-14)  Add `meta_parse_buffer` for parsing metadata
+                             from memory into a `meta_sink` callback or a
+                             growable `meta_buffer`.
+        2.1.0  (2026-10-14)  Render output into a memory buffer and only
+                             replace the header (via a temporary file and
+                             rename) when its contents changed.
+        2.0.2  (2026-10-14)  Replace the lazily built C type and keyword
+                             buckets with one static perfect hash table,
+                             which removes an initialization data race.
+        2.0.1  (2026-10-14)  Resolve object types and duplicates with one
+                             probe of the interned name table instead of
+                             a linear scan. `_hash` is replaced by the
+                             static `meta_hash_bytes`.
+        2.0.0  (2026-10-14)  Objects, fields and interned names are allo-
+                             cated from an arena owned by the context;
+                             no more MAX_FIELDS limits on objects or
+                             fields. Add `meta_context_free`. `meta_field`
+                             and `meta_object` now hold string pointers.
+        1.4.0  (2026-10-14)  Add `meta_context` and `meta_parse_ctx` so
+                             separate threads can parse at the same time.
+                             `meta_parse` uses a default context.
+        1.3.0  (2026-10-14)  Read input in one go (memory-mapped where
+                             available) and tokenize it with a hand-
+                             written lexer instead of fgets+sscanf.
+                             Lines are no longer limited in length.
         1.2.2  (2025-01-18)  Extra logging messages added where there
                              was lacking some.
         1.2.1  (2025-01-18)  Patch fix to comment out duplicate objects